@@ -0,0 +1,237 @@
+// File name: benchmark.c
+// Executable: benchmark
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Program to benchmark OSS (make bench). Runs ./oss over a matrix of scenarios, every workload x
+//  replacement policy x frame table size x PCB size, several times each, and reports for each
+//  scenario the mean and 95% confidence interval of the real request rate, the fault rate and the
+//  mean simulated latency, plus the latency percentiles. Results go to bench.csv and bench.json
+//  (or the -o prefix) so runs from different builds can be compared.
+//
+// Every run uses the USER pool (-F) and reads its numbers back from oss -o.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+#include <sys/wait.h>
+
+
+/* Constants */
+#define MAX_RUNS 30
+#define RUN_FILE "benchmark.run"
+
+// Two-sided 95% Student t values for 1 to 30 degrees of freedom.
+const double T_95[30] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+// Scenario matrix. -q only runs the first two workloads and policies at the last frame and PCB size.
+const char *workloads[] = { "uniform", "ws", "zipf", "mix" };
+const char *policies[] = { "sc", "lru", "fifo", "arc" };
+const char *frameCounts[] = { "128", "256" };
+const char *processCounts[] = { "8", "18" };
+
+
+/* Structures */
+// Numbers from one run of oss.
+typedef struct {
+    double faultRate;
+    double referencesPerSecond;
+    double latencyMean;
+    double latencyP50;
+    double latencyP99;
+    double latencyP999;
+} RunResult;
+
+// Mean and 95% confidence interval half-width of one number over the runs of a scenario.
+typedef struct {
+    double mean;
+    double ci95;
+} Summary;
+
+
+/* Function Prototypes */
+int runOss ( const char* workload, const char* policy, const char* frames, const char* processes, RunResult* result );
+Summary summarize ( const RunResult* results, int count, size_t offset );
+
+
+int main ( int argc, char *argv[] ) {
+    int runs = 3;
+    int quick = 0;
+    const char *prefix = "bench";
+    char csvName[256], jsonName[256];
+    RunResult results[MAX_RUNS];
+    Summary rate, faults, latency, p50, p99, p999;
+    FILE *csv, *json;
+    int w, p, f, s, r, count;
+    int workloadCount = 4, policyCount = 4, firstFrames = 0, firstProcesses = 0, scenarios = 0;
+    int opt;
+
+    while ( ( opt = getopt ( argc, argv, "hn:o:q" ) ) != -1 ) {
+        switch ( opt ) {
+            case 'n':
+                runs = atoi ( optarg );
+                if ( runs < 2 ) {
+                    runs = 2;
+                } else if ( runs > MAX_RUNS ) {
+                    runs = MAX_RUNS;
+                }
+                break;
+            case 'o':
+                prefix = optarg;
+                break;
+            case 'q':
+                quick = 1;
+                break;
+            default:
+                printf ( "Program: ./benchmark (run from the directory with oss and user)\n" );
+                printf ( "Options:\n" );
+                printf ( "\t-n : runs per scenario (2-%d, default 3)\n", MAX_RUNS );
+                printf ( "\t-o : prefix of the output files (default bench: bench.csv and bench.json)\n" );
+                printf ( "\t-q : quick matrix (uniform and ws, sc and lru, 256 frames, 18 processes)\n" );
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if ( quick ) {
+        workloadCount = 2;
+        policyCount = 2;
+        firstFrames = 1;
+        firstProcesses = 1;
+    }
+
+    snprintf ( csvName, sizeof ( csvName ), "%s.csv", prefix );
+    snprintf ( jsonName, sizeof ( jsonName ), "%s.json", prefix );
+    if ( ( csv = fopen ( csvName, "w" ) ) == NULL || ( json = fopen ( jsonName, "w" ) ) == NULL ) {
+        perror ( "BENCHMARK: Failure to create the output files" );
+        return 1;
+    }
+    fprintf ( csv, "workload,policy,frames,processes,runs,referencesPerSecond,referencesPerSecondCi95,faultRate,faultRateCi95,latencyMean,latencyMeanCi95,latencyP50,latencyP99,latencyP999\n" );
+    fprintf ( json, "{\n  \"runsPerScenario\": %d,\n  \"scenarios\": [", runs );
+
+    for ( w = 0; w < workloadCount; ++w ) {
+        for ( p = 0; p < policyCount; ++p ) {
+            for ( f = firstFrames; f < 2; ++f ) {
+                for ( s = firstProcesses; s < 2; ++s ) {
+                    count = 0;
+                    for ( r = 0; r < runs; ++r ) {
+                        if ( runOss ( workloads[w], policies[p], frameCounts[f], processCounts[s], &results[count] ) == 0 ) {
+                            count++;
+                        }
+                    }
+                    if ( count == 0 ) {
+                        fprintf ( stderr, "BENCHMARK: Every run of %s/%s/%s/%s failed.\n", workloads[w], policies[p], frameCounts[f], processCounts[s] );
+                        continue;
+                    }
+
+                    rate = summarize ( results, count, offsetof ( RunResult, referencesPerSecond ) );
+                    faults = summarize ( results, count, offsetof ( RunResult, faultRate ) );
+                    latency = summarize ( results, count, offsetof ( RunResult, latencyMean ) );
+                    p50 = summarize ( results, count, offsetof ( RunResult, latencyP50 ) );
+                    p99 = summarize ( results, count, offsetof ( RunResult, latencyP99 ) );
+                    p999 = summarize ( results, count, offsetof ( RunResult, latencyP999 ) );
+
+                    printf ( "%-8s %-5s %4s frames %3s processes: %9.0f +- %7.0f refs/s, %.4f +- %.4f faults/ref, latency mean %.0f p50 %.0f p99 %.0f p99.9 %.0f ns\n", workloads[w], policies[p], frameCounts[f], processCounts[s], rate.mean, rate.ci95, faults.mean, faults.ci95, latency.mean, p50.mean, p99.mean, p999.mean );
+                    fflush ( stdout );
+
+                    fprintf ( csv, "%s,%s,%s,%s,%d,%.1f,%.1f,%.6f,%.6f,%.1f,%.1f,%.0f,%.0f,%.0f\n", workloads[w], policies[p], frameCounts[f], processCounts[s], count, rate.mean, rate.ci95, faults.mean, faults.ci95, latency.mean, latency.ci95, p50.mean, p99.mean, p999.mean );
+                    fprintf ( json, "%s\n    { \"workload\": \"%s\", \"policy\": \"%s\", \"frames\": %s, \"processes\": %s, \"runs\": %d, "
+                        "\"referencesPerSecond\": { \"mean\": %.1f, \"ci95\": %.1f }, \"faultRate\": { \"mean\": %.6f, \"ci95\": %.6f }, "
+                        "\"latencyNs\": { \"mean\": %.1f, \"ci95\": %.1f, \"p50\": %.0f, \"p99\": %.0f, \"p999\": %.0f } }",
+                        scenarios > 0 ? "," : "", workloads[w], policies[p], frameCounts[f], processCounts[s], count, rate.mean, rate.ci95, faults.mean, faults.ci95, latency.mean, latency.ci95, p50.mean, p99.mean, p999.mean );
+                    scenarios++;
+                }
+            }
+        }
+    }
+
+    fprintf ( json, "\n  ]\n}\n" );
+    fclose ( csv );
+    fclose ( json );
+    unlink ( RUN_FILE );
+
+    printf ( "%d scenarios written to %s and %s.\n", scenarios, csvName, jsonName );
+    return 0;
+}
+
+
+/* Function Definitions */
+
+// Function to run oss once on a scenario and read back its results. oss gets its own process group, since it
+//  kills its whole group when the alarm cuts a run short. Returns 1 if the run failed.
+int runOss ( const char* workload, const char* policy, const char* frames, const char* processes, RunResult* result ) {
+    char line[512];
+    char *field;
+    double values[16];
+    int status, i, devNull;
+    pid_t pid;
+    FILE *in;
+
+    unlink ( RUN_FILE );
+
+    if ( ( pid = fork() ) == -1 ) {
+        perror ( "BENCHMARK: Failure to fork oss" );
+        return 1;
+    }
+    if ( pid == 0 ) {
+        setpgid ( 0, 0 );
+        if ( ( devNull = open ( "/dev/null", O_WRONLY ) ) != -1 ) {
+            dup2 ( devNull, STDOUT_FILENO );
+            dup2 ( devNull, STDERR_FILENO );
+        }
+        execl ( "./oss", "oss", "-F", "-W", workload, "-p", policy, "-f", frames, "-s", processes, "-o", RUN_FILE, NULL );
+        _exit ( 1 );
+    }
+    waitpid ( pid, &status, 0 );
+
+    // Skip the header, then split the results line. The first two fields are names.
+    if ( ( in = fopen ( RUN_FILE, "r" ) ) == NULL ) {
+        return 1;
+    }
+    if ( fgets ( line, sizeof ( line ), in ) == NULL || fgets ( line, sizeof ( line ), in ) == NULL ) {
+        fclose ( in );
+        return 1;
+    }
+    fclose ( in );
+
+    for ( i = 0, field = strtok ( line, "," ); field != NULL && i < 16; ++i, field = strtok ( NULL, "," ) ) {
+        values[i] = atof ( field );
+    }
+    if ( i < 16 || values[6] == 0 ) {
+        return 1;
+    }
+
+    result->faultRate = values[8];
+    result->referencesPerSecond = values[10];
+    result->latencyMean = values[12];
+    result->latencyP50 = values[13];
+    result->latencyP99 = values[14];
+    result->latencyP999 = values[15];
+    return 0;
+}
+
+// Function to get the mean and 95% confidence interval of the field at offset over count results.
+Summary summarize ( const RunResult* results, int count, size_t offset ) {
+    Summary summary = { 0.0, 0.0 };
+    double value, squares = 0.0;
+    int i;
+
+    for ( i = 0; i < count; ++i ) {
+        summary.mean += *(const double*) ( (const char*) &results[i] + offset );
+    }
+    summary.mean /= count;
+
+    if ( count > 1 ) {
+        for ( i = 0; i < count; ++i ) {
+            value = *(const double*) ( (const char*) &results[i] + offset ) - summary.mean;
+            squares += value * value;
+        }
+        summary.ci95 = T_95[count - 2] * sqrt ( squares / ( count - 1 ) ) / sqrt ( count );
+    }
+
+    return summary;
+}
@@ -0,0 +1,115 @@
+// File name: buddy.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Buddy allocator over the frame table. See buddy.h.
+
+#include "buddy.h"
+
+#include <stdlib.h>
+
+
+/* Free list helpers */
+// Function to put the run starting at frame on the free list of its order.
+static void pushRun ( Buddy* buddy, int frame, int order ) {
+    int at = frame - buddy->base;
+
+    buddy->orders[at] = order + 1;
+    buddy->previous[at] = -1;
+    buddy->next[at] = buddy->heads[order];
+    if ( buddy->heads[order] != -1 ) {
+        buddy->previous[buddy->heads[order] - buddy->base] = frame;
+    }
+    buddy->heads[order] = frame;
+}
+
+// Function to take the run starting at frame off the free list of its order.
+static void removeRun ( Buddy* buddy, int frame, int order ) {
+    int at = frame - buddy->base;
+
+    buddy->orders[at] = 0;
+    if ( buddy->previous[at] != -1 ) {
+        buddy->next[buddy->previous[at] - buddy->base] = buddy->next[at];
+    } else {
+        buddy->heads[order] = buddy->next[at];
+    }
+    if ( buddy->next[at] != -1 ) {
+        buddy->previous[buddy->next[at] - buddy->base] = buddy->previous[at];
+    }
+}
+
+
+/* Function Definitions */
+
+// Function to create an allocator for the frames frames starting at base, a multiple of 2^maxOrder, with runs of up
+//  to 2^maxOrder frames. It starts out with nothing free. Returns NULL if its tables can't be allocated.
+Buddy* createBuddy ( int base, int frames, int maxOrder ) {
+    Buddy* buddy = (Buddy*) calloc ( 1, sizeof ( Buddy ) );
+    int i;
+
+    buddy->base = base;
+    buddy->frames = frames;
+    buddy->maxOrder = maxOrder;
+    buddy->heads = (int*) malloc ( ( maxOrder + 1 ) * sizeof ( int ) );
+    buddy->next = (int*) malloc ( ( frames > 0 ? frames : 1 ) * sizeof ( int ) );
+    buddy->previous = (int*) malloc ( ( frames > 0 ? frames : 1 ) * sizeof ( int ) );
+    buddy->orders = (unsigned char*) calloc ( frames > 0 ? frames : 1, 1 );
+    if ( buddy->heads == NULL || buddy->next == NULL || buddy->previous == NULL || buddy->orders == NULL ) {
+        destroyBuddy ( buddy );
+        return NULL;
+    }
+
+    for ( i = 0; i <= maxOrder; ++i ) {
+        buddy->heads[i] = -1;
+    }
+    return buddy;
+}
+
+void destroyBuddy ( Buddy* buddy ) {
+    free ( buddy->heads );
+    free ( buddy->next );
+    free ( buddy->previous );
+    free ( buddy->orders );
+    free ( buddy );
+}
+
+// Function to take a free run of 2^order frames. The smallest free run big enough is split, keeping its
+//  first frames and putting the halves after them back on the free lists, so single frames taken one
+//  after another come from the same run in order. Returns its first frame, -1 if there is no run that big.
+int buddyAllocate ( Buddy* buddy, int order ) {
+    int found = order, frame;
+
+    while ( found <= buddy->maxOrder && buddy->heads[found] == -1 ) {
+        found++;
+    }
+    if ( found > buddy->maxOrder ) {
+        return -1;
+    }
+
+    frame = buddy->heads[found];
+    removeRun ( buddy, frame, found );
+    while ( found > order ) {
+        found--;
+        pushRun ( buddy, frame + ( 1 << found ), found );
+    }
+    buddy->freeFrames -= 1 << order;
+    return frame;
+}
+
+// Function to give back the run of 2^order frames starting at frame, merging it with its buddy for as long as
+//  that one is free. The range starts on a multiple of 2^maxOrder, so a buddy is never before it.
+void buddyFree ( Buddy* buddy, int frame, int order ) {
+    int partner;
+
+    buddy->freeFrames += 1 << order;
+    while ( order < buddy->maxOrder ) {
+        partner = frame ^ ( 1 << order );
+        if ( partner + ( 1 << order ) > buddy->base + buddy->frames || buddy->orders[partner - buddy->base] != order + 1 ) {
+            break;
+        }
+        removeRun ( buddy, partner, order );
+        frame &= partner;
+        order++;
+    }
+    pushRun ( buddy, frame, order );
+}
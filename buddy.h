@@ -0,0 +1,39 @@
+// File name: buddy.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the buddy allocator the pager keeps its free frames in. Free frames are kept as
+//  aligned runs of 2^order frames, up to 2^maxOrder, with a free list per order. Taking a run splits
+//  a bigger one if there is none of the size asked for, and a run given back merges with its buddy
+//  (the other half of the run it was split from) whenever that one is free too, so a huge page (see
+//  pager.h) can find its frames in a row. With a maxOrder of 0 it is a stack of single frames.
+//
+// Each pager shard has its own allocator over the range of frames it owns, which starts on a multiple
+//  of 2^maxOrder, so its runs line up with the frame table's. A frame is always given back to the
+//  allocator of the shard that owns it.
+
+#ifndef buddy_h
+#define buddy_h
+
+
+/* Structures */
+typedef struct {
+    int base;                   // First frame of the range. Frames are numbered as in the frame table.
+    int frames;
+    int maxOrder;
+    int freeFrames;
+    int *heads;                 // First run on the free list of each order, -1 if there is none.
+    int *next;                  // By frame - base, set for the first frame of each free run.
+    int *previous;
+    unsigned char *orders;      // By frame - base: 1 + the order of the free run it starts, 0 if it doesn't start one.
+} Buddy;
+
+
+/* Function Prototypes */
+Buddy* createBuddy ( int base, int frames, int maxOrder );
+void destroyBuddy ( Buddy* buddy );
+int buddyAllocate ( Buddy* buddy, int order );
+void buddyFree ( Buddy* buddy, int frame, int order );
+
+#endif
@@ -0,0 +1,52 @@
+// File name: disk.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Simulated paging disk and its wait queue. See disk.h.
+
+#include "disk.h"
+
+#include <stdlib.h>
+
+
+/* Function Definitions */
+
+Disk* createDisk() {
+    return (Disk*) calloc ( 1, sizeof ( Disk ) );
+}
+
+void destroyDisk ( Disk* disk ) {
+    free ( disk );
+}
+
+// Function to queue one I/O on the device. It starts once everything ahead of it is done (or now, if
+//  the device is idle). Returns the simulated time it finishes.
+unsigned long long diskSubmit ( Disk* disk, unsigned long long now, unsigned long long serviceTime, bool write ) {
+    if ( disk->busyUntil < now ) {
+        disk->busyUntil = now;
+    }
+    disk->busyUntil += serviceTime;
+
+    if ( write ) {
+        disk->writes++;
+    } else {
+        disk->reads++;
+    }
+
+    return disk->busyUntil;
+}
+
+// Function to count a process as parked from now until its I/O finishes at completion.
+void diskPark ( Disk* disk, unsigned long long now, unsigned long long completion ) {
+    disk->count++;
+
+    disk->totalWait += completion - now;
+    if ( disk->count > disk->maxWaiting ) {
+        disk->maxWaiting = disk->count;
+    }
+}
+
+// Function to count a parked process as resumed once its I/O is done.
+void diskResume ( Disk* disk ) {
+    disk->count--;
+}
@@ -0,0 +1,38 @@
+// File name: disk.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the simulated paging disk. Page-ins and dirty page writebacks are
+//  queued on one device and served first come, first served. A process that faults is
+//  parked until the simulated clock passes the time its I/O finishes, and OSS keeps serving
+//  other processes in the meantime. OSS schedules the wake-up on its event queue
+//  (eventqueue.h); the disk only counts who is waiting.
+
+#ifndef disk_h
+#define disk_h
+
+#include <stdbool.h>
+
+
+/* Structures */
+typedef struct {
+    unsigned long long busyUntil;       // Simulated time (ns) the device finishes what is queued.
+    int count;                          // Processes parked waiting on their I/O.
+
+    // Statistics
+    long reads;
+    long writes;
+    unsigned long long totalWait;       // Sum over parked processes of how long they waited.
+    int maxWaiting;
+} Disk;
+
+
+/* Function Prototypes */
+Disk* createDisk ( void );
+void destroyDisk ( Disk* disk );
+unsigned long long diskSubmit ( Disk* disk, unsigned long long now, unsigned long long serviceTime, bool write );
+void diskPark ( Disk* disk, unsigned long long now, unsigned long long completion );
+void diskResume ( Disk* disk );
+
+#endif
@@ -0,0 +1,213 @@
+// File name: eventlog.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Event log ring and its writer thread. See eventlog.h.
+
+#include "eventlog.h"
+#include "simclock.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sched.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/* Writer thread */
+
+// Function to write a buffer out in full.
+static void writeAll ( int fd, const void* buffer, size_t size ) {
+    const char* next = (const char*) buffer;
+    ssize_t count;
+
+    while ( size > 0 && ( count = write ( fd, next, size ) ) > 0 ) {
+        next += count;
+        size -= count;
+    }
+}
+
+// Function run by the writer thread. Copies every finished record off the ring into a batch, frees
+//  the slots and writes the batch. Sleeps a millisecond when the ring is empty. Once the log is
+//  closed it stops at the first empty slot: every producer has finished by then, except one a
+//  signal interrupted mid-record, whose record is dropped.
+static void* eventWriter ( void* arg ) {
+    EventLog* log = (EventLog*) arg;
+    EventRecord* batch = (EventRecord*) malloc ( EVENT_LOG_BATCH * sizeof ( EventRecord ) );
+    struct timespec pause = { 0, 1000000 };
+    EventRecord* slot;
+    unsigned long tail = log->tail;
+    int count;
+
+    while ( 1 ) {
+        count = 0;
+        while ( count < EVENT_LOG_BATCH ) {
+            slot = &log->ring[tail & ( EVENT_LOG_CAPACITY - 1 )];
+            if ( __atomic_load_n ( &slot->type, __ATOMIC_ACQUIRE ) == EVENT_NONE ) {
+                break;
+            }
+            batch[count++] = *slot;
+            slot->type = EVENT_NONE;
+            tail++;
+        }
+        __atomic_store_n ( &log->tail, tail, __ATOMIC_RELEASE );
+
+        if ( count > 0 ) {
+            writeAll ( log->fd, batch, count * sizeof ( EventRecord ) );
+            log->written += count;
+        } else if ( __atomic_load_n ( &log->stopping, __ATOMIC_ACQUIRE ) ) {
+            break;
+        } else {
+            nanosleep ( &pause, NULL );
+        }
+    }
+
+    free ( batch );
+    return NULL;
+}
+
+
+/* Function Definitions */
+
+// Function to create the event log file and start its writer thread. The writer never takes a signal, so
+//  OSS's signal handlers always run on one of its own threads. closeEventLog joins the writer, so it must only
+//  be called once. Returns NULL if the file can't be created.
+EventLog* openEventLog ( const char* fileName ) {
+    EventLog* log;
+    EventLogHeader header;
+    sigset_t all, old;
+
+    memset ( &header, 0, sizeof ( header ) );
+    memcpy ( header.magic, EVENT_LOG_MAGIC, sizeof ( header.magic ) );
+    header.version = EVENT_LOG_VERSION;
+    header.recordSize = sizeof ( EventRecord );
+
+    log = (EventLog*) calloc ( 1, sizeof ( EventLog ) );
+    if ( ( log->fd = open ( fileName, O_WRONLY | O_CREAT | O_TRUNC, 0666 ) ) == -1 ) {
+        free ( log );
+        return NULL;
+    }
+    writeAll ( log->fd, &header, sizeof ( header ) );
+    log->ring = (EventRecord*) calloc ( EVENT_LOG_CAPACITY, sizeof ( EventRecord ) );
+
+    sigfillset ( &all );
+    pthread_sigmask ( SIG_BLOCK, &all, &old );
+    pthread_create ( &log->writer, NULL, eventWriter, log );
+    pthread_sigmask ( SIG_SETMASK, &old, NULL );
+
+    return log;
+}
+
+// Function to write out whatever is left on the ring, stop the writer thread and close the file. The
+//  statistics stay readable until destroyEventLog.
+void closeEventLog ( EventLog* log ) {
+    __atomic_store_n ( &log->stopping, true, __ATOMIC_RELEASE );
+    pthread_join ( log->writer, NULL );
+
+    close ( log->fd );
+}
+
+void destroyEventLog ( EventLog* log ) {
+    free ( log->ring );
+    free ( log );
+}
+
+// Function to add an event to the log. Safe to call from any number of threads at once. Does nothing if
+//  there is no log.
+void logEvent ( EventLog* log, int type, long pid, int blockIndex, int frame, int value, uint64_t time ) {
+    unsigned long position;
+    EventRecord* slot;
+
+    if ( log == NULL ) {
+        return;
+    }
+
+    position = __atomic_fetch_add ( &log->head, 1, __ATOMIC_RELAXED );
+
+    // The ring is full. Wait for the writer to drain the slot this position lands on.
+    if ( position - __atomic_load_n ( &log->tail, __ATOMIC_ACQUIRE ) >= EVENT_LOG_CAPACITY ) {
+        __atomic_add_fetch ( &log->waits, 1, __ATOMIC_RELAXED );
+        while ( position - __atomic_load_n ( &log->tail, __ATOMIC_ACQUIRE ) >= EVENT_LOG_CAPACITY ) {
+            sched_yield();
+        }
+    }
+
+    slot = &log->ring[position & ( EVENT_LOG_CAPACITY - 1 )];
+    slot->blockIndex = blockIndex;
+    slot->pid = pid;
+    slot->time = time;
+    slot->frame = frame;
+    slot->value = value;
+    __atomic_store_n ( &slot->type, type, __ATOMIC_RELEASE );
+}
+
+// Function to read and check the header of an event log. Returns false if it isn't one this build can read.
+bool readEventLogHeader ( FILE* in ) {
+    EventLogHeader header;
+
+    return fread ( &header, sizeof ( header ), 1, in ) == 1 && memcmp ( header.magic, EVENT_LOG_MAGIC, sizeof ( header.magic ) ) == 0
+        && header.version == EVENT_LOG_VERSION && header.recordSize == sizeof ( EventRecord );
+}
+
+// Function to print an event as the line OSS logs it as.
+void printEvent ( FILE* out, const EventRecord* record ) {
+    long pid = (long) record->pid;
+    unsigned int seconds = clockSeconds ( record->time );
+    unsigned int nanoseconds = clockNanoseconds ( record->time );
+
+    switch ( record->type ) {
+        case EVENT_CREATED:
+            fprintf( out, "OSS: Created Process: %ld. Stored in PCB at Index: %d. Time: %u:%u.\n", pid, record->blockIndex, seconds, nanoseconds );
+            break;
+        case EVENT_TERMINATED:
+            fprintf( out, "OSS: Process %ld terminated at %u:%u.\n", pid, seconds, nanoseconds );
+            break;
+        case EVENT_READ:
+            fprintf( out, "OSS: Process %ld requesting READ of address %d at time %u:%u.\n", pid, record->value, seconds, nanoseconds );
+            break;
+        case EVENT_WRITE:
+            fprintf( out, "OSS: Process %ld requesting WRITE to address %d at time %u:%u.\n", pid, record->value, seconds, nanoseconds );
+            break;
+        case EVENT_GRANTED:
+            fprintf( out, "OSS: Address %d in Frame %d. Giving data to Process %ld at time %u:%u.\n", record->value, record->frame, pid, seconds, nanoseconds );
+            break;
+        case EVENT_GRANTED_DIRTY:
+            fprintf( out, "OSS: Address %d in Frame %d. Dirty bit was set. Giving data to Process %ld at time %u:%u.\n", record->value, record->frame, pid, seconds, nanoseconds );
+            break;
+        case EVENT_SWAP:
+            fprintf( out, "OSS: Clearing frame %d and swapping in Process %ld Page %d.\n", record->frame, pid, record->value );
+            break;
+        case EVENT_DISK_WAIT:
+            fprintf( out, "OSS: Process %ld waiting on disk until %u:%u.\n", pid, seconds, nanoseconds );
+            break;
+        case EVENT_DISK_DONE:
+            fprintf( out, "OSS: Disk done for Process %ld. Resuming it at time %u:%u.\n", pid, seconds, nanoseconds );
+            break;
+        case EVENT_SAMPLE:
+            fprintf( out, "OSS: Sample at time %u:%u: %d processes active, %d waiting on disk, %d created so far.\n", seconds, nanoseconds, record->value, record->frame, record->blockIndex );
+            break;
+        case EVENT_CLEAN:
+            fprintf( out, "OSS: Page cleaner writing back %d dirty pages of Process %ld from Page %d, done at %u:%u.\n", record->value, pid, record->frame, seconds, nanoseconds );
+            break;
+        case EVENT_PREFETCH:
+            fprintf( out, "OSS: Reading ahead Page %d of Process %ld into Frame %d, done at %u:%u.\n", record->value, pid, record->frame, seconds, nanoseconds );
+            break;
+        case EVENT_FORK:
+            fprintf( out, "OSS: Process %ld forked from the process in PCB index %d, sharing %d pages copy-on-write at time %u:%u.\n", pid, record->frame, record->value, seconds, nanoseconds );
+            break;
+        case EVENT_COPY:
+            fprintf( out, "OSS: Copying Page %d of Process %ld into Frame %d on a write at time %u:%u.\n", record->value, pid, record->frame, seconds, nanoseconds );
+            break;
+        case EVENT_PROMOTE:
+            fprintf( out, "OSS: Process %ld given %d huge pages, copying %d pages into runs of frames for them, at time %u:%u.\n", pid, record->value, record->frame, seconds, nanoseconds );
+            break;
+        case EVENT_DEMOTE:
+            fprintf( out, "OSS: Splitting up the huge page of the process in PCB index %d to evict its Page %d from Frame %d at time %u:%u.\n", record->blockIndex, record->value, record->frame, seconds, nanoseconds );
+            break;
+        default:
+            fprintf( out, "OSS: Unknown event %d.\n", record->type );
+            break;
+    }
+}
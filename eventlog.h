@@ -0,0 +1,93 @@
+// File name: eventlog.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the OSS event log. Every process, hit, fault and disk event is a fixed-size
+//  binary record. OSS threads put records into an in-memory ring without taking a lock, and a
+//  background thread drains the ring to the event log file in large writes. logdecode turns the
+//  file back into the text lines OSS used to print (see printEvent).
+//
+// File layout: a 16 byte header, then the records in the order they were logged.
+
+#ifndef eventlog_h
+#define eventlog_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+
+
+/* Constants */
+#define EVENT_LOG_MAGIC "OSSEVENT"
+#define EVENT_LOG_VERSION 2
+#define EVENT_LOG_CAPACITY ( 1 << 16 )  // Records the ring holds. Must be a power of two.
+#define EVENT_LOG_BATCH 4096            // Most records the writer thread writes at once.
+
+// Event types. The comment on each is the line printEvent makes from it.
+enum {
+    EVENT_NONE = 0,
+    EVENT_CREATED,          // Created Process: pid. Stored in PCB at Index: blockIndex. Time: time.
+    EVENT_TERMINATED,       // Process pid terminated at time.
+    EVENT_READ,             // Process pid requesting READ of address value at time.
+    EVENT_WRITE,            // Process pid requesting WRITE to address value at time.
+    EVENT_GRANTED,          // Address value in Frame frame. Giving data to Process pid at time.
+    EVENT_GRANTED_DIRTY,    // Address value in Frame frame. Dirty bit was set. Giving data to Process pid at time.
+    EVENT_SWAP,             // Clearing frame frame and swapping in Process pid Page value.
+    EVENT_DISK_WAIT,        // Process pid waiting on disk until time.
+    EVENT_DISK_DONE,        // Disk done for Process pid. Resuming it at time.
+    EVENT_SAMPLE,           // Sample at time: value processes active, frame waiting on disk, blockIndex created so far.
+    EVENT_CLEAN,            // Page cleaner writing back value dirty pages of Process pid from Page frame, done at time.
+    EVENT_PREFETCH,         // Reading ahead Page value of Process pid into Frame frame, done at time.
+    EVENT_FORK,             // Process pid forked from the process in PCB index frame, sharing value pages copy-on-write at time.
+    EVENT_COPY,             // Copying Page value of Process pid into Frame frame on a write at time.
+    EVENT_PROMOTE,          // Process pid given value huge pages, copying frame pages into runs of frames for them, at time.
+    EVENT_DEMOTE            // Splitting up the huge page of the process in PCB index blockIndex to evict its Page value from Frame frame at time.
+};
+
+
+/* Structures */
+// Header at the start of every event log file.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+} EventLogHeader;
+
+// One event. 32 bytes. type is written last, so a slot in the ring holds a whole record once its
+//  type is set.
+typedef struct {
+    int32_t type;
+    int32_t blockIndex;
+    int64_t pid;
+    uint64_t time;              // Simulated time in nanoseconds.
+    int32_t frame;
+    int32_t value;              // Address or page, depending on the type.
+} EventRecord;
+
+// The ring and its writer thread. Producers take a position with an atomic add on head and wait
+//  (rarely) for the writer to free the slot that many records back.
+typedef struct {
+    int fd;
+    EventRecord *ring;
+    unsigned long head;         // Next position a producer takes.
+    unsigned long tail;         // Next position the writer drains.
+    bool stopping;
+    pthread_t writer;
+
+    // Statistics
+    unsigned long waits;        // Times a producer found the ring full.
+    unsigned long written;
+} EventLog;
+
+
+/* Function Prototypes */
+EventLog* openEventLog ( const char* fileName );
+void closeEventLog ( EventLog* log );
+void destroyEventLog ( EventLog* log );
+void logEvent ( EventLog* log, int type, long pid, int blockIndex, int frame, int value, uint64_t time );
+bool readEventLogHeader ( FILE* in );
+void printEvent ( FILE* out, const EventRecord* record );
+
+#endif
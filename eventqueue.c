@@ -0,0 +1,100 @@
+// File name: eventqueue.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Binary min-heap of scheduled events. See eventqueue.h.
+
+#include "eventqueue.h"
+
+#include <stdlib.h>
+
+
+/* Heap */
+
+// Function to check if event a is due before event b.
+static bool earlier ( const ScheduledEvent* a, const ScheduledEvent* b ) {
+    return a->time < b->time || ( a->time == b->time && a->sequence < b->sequence );
+}
+
+static void swapEvents ( ScheduledEvent* a, ScheduledEvent* b ) {
+    ScheduledEvent temp = *a;
+
+    *a = *b;
+    *b = temp;
+}
+
+
+/* Function Definitions */
+
+// Function to create an empty queue with room for capacity events. It grows if more are scheduled.
+EventQueue* createEventQueue ( int capacity ) {
+    EventQueue* queue = (EventQueue*) calloc ( 1, sizeof ( EventQueue ) );
+
+    queue->capacity = capacity > 0 ? capacity : 1;
+    queue->heap = (ScheduledEvent*) malloc ( queue->capacity * sizeof ( ScheduledEvent ) );
+
+    return queue;
+}
+
+void destroyEventQueue ( EventQueue* queue ) {
+    free ( queue->heap );
+    free ( queue );
+}
+
+// Function to schedule an event of the given type for the given time.
+void scheduleEvent ( EventQueue* queue, uint64_t time, int type, int blockIndex ) {
+    int i, parent;
+
+    if ( queue->count == queue->capacity ) {
+        queue->capacity *= 2;
+        queue->heap = (ScheduledEvent*) realloc ( queue->heap, queue->capacity * sizeof ( ScheduledEvent ) );
+    }
+
+    i = queue->count++;
+    queue->heap[i].time = time;
+    queue->heap[i].sequence = queue->nextSequence++;
+    queue->heap[i].type = type;
+    queue->heap[i].blockIndex = blockIndex;
+
+    // Sift it up past every later event.
+    while ( i > 0 && earlier ( &queue->heap[i], &queue->heap[parent = ( i - 1 ) / 2] ) ) {
+        swapEvents ( &queue->heap[i], &queue->heap[parent] );
+        i = parent;
+    }
+}
+
+// Function to get the time of the next event. Returns false if nothing is scheduled.
+bool nextEventTime ( const EventQueue* queue, uint64_t* time ) {
+    if ( queue->count == 0 ) {
+        return false;
+    }
+
+    *time = queue->heap[0].time;
+    return true;
+}
+
+// Function to take the next event off the queue if it is due by now. Returns false if nothing is due.
+bool takeDueEvent ( EventQueue* queue, uint64_t now, ScheduledEvent* event ) {
+    int i = 0, child;
+
+    if ( queue->count == 0 || queue->heap[0].time > now ) {
+        return false;
+    }
+
+    *event = queue->heap[0];
+    queue->heap[0] = queue->heap[--queue->count];
+
+    // Sift the moved event down below every earlier one.
+    while ( ( child = 2 * i + 1 ) < queue->count ) {
+        if ( child + 1 < queue->count && earlier ( &queue->heap[child + 1], &queue->heap[child] ) ) {
+            child++;
+        }
+        if ( !earlier ( &queue->heap[child], &queue->heap[i] ) ) {
+            break;
+        }
+        swapEvents ( &queue->heap[i], &queue->heap[child] );
+        i = child;
+    }
+
+    return true;
+}
@@ -0,0 +1,42 @@
+// File name: eventqueue.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the OSS discrete-event queue. Everything OSS does at a set simulated time
+//  (creating a process, a page fault's I/O finishing, sampling statistics) is an event on a
+//  binary min-heap keyed on that time. OSS runs each event once the clock reaches it, and when
+//  no USER is able to run it moves the clock straight to the next event instead of waiting.
+
+#ifndef eventqueue_h
+#define eventqueue_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/* Structures */
+// One scheduled event. Events due at the same time run in the order they were scheduled.
+typedef struct {
+    uint64_t time;              // Simulated time (ns) the event is due.
+    unsigned long sequence;     // Order it was scheduled in. Breaks ties between equal times.
+    int type;                   // What to do. Up to the caller (see oss.c).
+    int blockIndex;             // PCB index it is for, or -1.
+} ScheduledEvent;
+
+typedef struct {
+    ScheduledEvent *heap;
+    int count;
+    int capacity;
+    unsigned long nextSequence;
+} EventQueue;
+
+
+/* Function Prototypes */
+EventQueue* createEventQueue ( int capacity );
+void destroyEventQueue ( EventQueue* queue );
+void scheduleEvent ( EventQueue* queue, uint64_t time, int type, int blockIndex );
+bool nextEventTime ( const EventQueue* queue, uint64_t* time );
+bool takeDueEvent ( EventQueue* queue, uint64_t now, ScheduledEvent* event );
+
+#endif
@@ -24,6 +24,11 @@
 #include <sys/types.h>
 #include <sys/time.h>
 #include <stdbool.h>
+#include <stddef.h>
+
+#include "ring.h"
+#include "simclock.h"
+#include "stats.h"
 
 
 /* Structures */
@@ -39,6 +44,34 @@ typedef struct {
     unsigned int sentTime[2];
 } Message;
 
+// Largest number of memory references USER can send in one batch (oss -b).
+#define MAX_BATCH 256
+
+// Results OSS fills in for each reference in a batch.
+enum { REFERENCE_HIT = 0, REFERENCE_FAULT = 1 };
+
+// One memory reference inside a batch.
+typedef struct {
+    int pageRef;
+    int memoryAddress;
+    int requestType;
+    int result;
+} Reference;
+
+// Structure of a batched request used in batch mode. USER fills count references and OSS sends the same
+//  structure back with each result set. Only the first count entries are sent, see batchMessageSize.
+typedef struct {
+    long msg_type;
+    long pid;
+    int blockIndex;
+    int count;
+    int terminate;
+    unsigned int sentTime[2];
+    Reference refs[MAX_BATCH];
+} BatchMessage;
+
+#define batchMessageSize(n) ( offsetof ( BatchMessage, refs ) + ( n ) * sizeof ( Reference ) )
+
 
 /* Function Prototypes */
 void sig_handle ( int sig_num );
@@ -46,13 +79,29 @@ void sig_handle ( int sig_num );
 
 /* Shared Memory */
 int shmClockID;
-int *shmClock;
+SimClock *shmClock;
 key_t shmKey = 1993;
 
+// Ring transport segment. Only used when oss is run with -r.
+int shmRingID;
+RingSet *shmRing;
+key_t shmRingKey = 1997;
+
+// Live statistics segment OSS publishes to and ./ossstat reads (see stats.h).
+int shmStatsID;
+StatsSegment *shmStats;
+key_t shmStatsKey = 1999;
+
 
 /* Message Queue */
-Message message;
+// Thread-local so each OSS worker thread (oss -w) has its own request in flight.
+__thread Message message;
+__thread BatchMessage batch;
 int messageID;
 key_t messageKey = 1995; 
 
+// Transport selected by OSS and passed to USER through execl.
+enum { TRANSPORT_MSGQUEUE = 0, TRANSPORT_RING = 1 };
+int transport = TRANSPORT_MSGQUEUE;
+
 #endif
@@ -0,0 +1,87 @@
+// File name: histogram.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Lock-free log-linear latency histograms. See histogram.h.
+
+#include "histogram.h"
+
+#include <stdbool.h>
+#include <math.h>
+
+
+/* Buckets */
+
+#define HALF ( 1 << ( HISTOGRAM_SUB_BITS - 1 ) )
+
+// Function to get the bucket a value is counted in.
+static int bucketOf ( uint64_t value ) {
+    int exponent;
+
+    if ( value < ( 1 << HISTOGRAM_SUB_BITS ) ) {
+        return (int) value;
+    }
+
+    // Keep the top HISTOGRAM_SUB_BITS bits of the value. The first is always set, so it is dropped.
+    exponent = 63 - __builtin_clzll ( value );
+    return ( exponent - HISTOGRAM_SUB_BITS + 2 ) * HALF + (int) ( ( value >> ( exponent - HISTOGRAM_SUB_BITS + 1 ) ) - HALF );
+}
+
+// Function to get the largest value counted in a bucket.
+static uint64_t bucketTop ( int bucket ) {
+    int shift;
+
+    if ( bucket < ( 1 << HISTOGRAM_SUB_BITS ) ) {
+        return (uint64_t) bucket;
+    }
+
+    shift = bucket / HALF - 1;
+    return ( ( (uint64_t) ( bucket % HALF + HALF + 1 ) ) << shift ) - 1;
+}
+
+
+/* Function Definitions */
+
+// Function to count a value count times (a batch of references that all took the same time).
+void histogramRecord ( Histogram* histogram, uint64_t value, unsigned long count ) {
+    uint64_t max = __atomic_load_n ( &histogram->max, __ATOMIC_RELAXED );
+
+    __atomic_fetch_add ( &histogram->counts[bucketOf ( value )], count, __ATOMIC_RELAXED );
+    __atomic_fetch_add ( &histogram->total, count, __ATOMIC_RELAXED );
+    __atomic_fetch_add ( &histogram->sum, value * count, __ATOMIC_RELAXED );
+
+    while ( value > max && !__atomic_compare_exchange_n ( &histogram->max, &max, value, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+    }
+}
+
+// Function to get the value at a percentile (0-100): the smallest bucket top that at least that share of the
+//  values are at or below. Returns 0 for an empty histogram.
+uint64_t histogramPercentile ( const Histogram* histogram, double percentile ) {
+    unsigned long total = __atomic_load_n ( &histogram->total, __ATOMIC_RELAXED );
+    unsigned long target = (unsigned long) ceil ( percentile / 100.0 * total );
+    unsigned long seen = 0;
+    uint64_t max = __atomic_load_n ( &histogram->max, __ATOMIC_RELAXED );
+    int i;
+
+    if ( total == 0 ) {
+        return 0;
+    }
+    if ( target < 1 ) {
+        target = 1;
+    }
+
+    for ( i = 0; i < HISTOGRAM_BUCKETS; ++i ) {
+        seen += __atomic_load_n ( &histogram->counts[i], __ATOMIC_RELAXED );
+        if ( seen >= target ) {
+            return bucketTop ( i ) < max ? bucketTop ( i ) : max;
+        }
+    }
+
+    return max;
+}
+
+double histogramMean ( const Histogram* histogram ) {
+    unsigned long total = __atomic_load_n ( &histogram->total, __ATOMIC_RELAXED );
+
+    return total > 0 ? (double) __atomic_load_n ( &histogram->sum, __ATOMIC_RELAXED ) / total : 0.0;
+}
@@ -0,0 +1,37 @@
+// File name: histogram.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the latency histograms. Buckets are log-linear like an HDR histogram: values
+//  below 2^HISTOGRAM_SUB_BITS get a bucket each, and every power of two above that is split into
+//  2^(HISTOGRAM_SUB_BITS - 1) equal buckets, so any 64-bit value is kept to within 1/128 of itself
+//  in a fixed 58KB table. Recording is a couple of relaxed atomic adds and needs no lock, so any
+//  number of threads can record into the same histogram.
+
+#ifndef histogram_h
+#define histogram_h
+
+#include <stdint.h>
+
+
+/* Constants */
+#define HISTOGRAM_SUB_BITS 8
+#define HISTOGRAM_BUCKETS ( ( 66 - HISTOGRAM_SUB_BITS ) << ( HISTOGRAM_SUB_BITS - 1 ) )
+
+
+/* Structures */
+typedef struct {
+    unsigned long counts[HISTOGRAM_BUCKETS];
+    unsigned long total;
+    uint64_t sum;
+    uint64_t max;
+} Histogram;
+
+
+/* Function Prototypes */
+void histogramRecord ( Histogram* histogram, uint64_t value, unsigned long count );
+uint64_t histogramPercentile ( const Histogram* histogram, double percentile );
+double histogramMean ( const Histogram* histogram );
+
+#endif
@@ -0,0 +1,38 @@
+// File name: logdecode.c
+// Executable: logdecode
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Program to turn an OSS event log (program.events by default) back into the text lines
+//  OSS logs. See eventlog.h.
+
+#include "eventlog.h"
+
+#include <stdlib.h>
+
+
+int main ( int argc, char *argv[] ) {
+    const char *fileName = ( argc > 1 ) ? argv[1] : "program.events";
+    EventRecord records[EVENT_LOG_BATCH];
+    size_t count, i;
+    FILE *in;
+
+    if ( ( in = fopen ( fileName, "r" ) ) == NULL ) {
+        perror ( "LOGDECODE: Failure to open the event log" );
+        return 1;
+    }
+    if ( !readEventLogHeader ( in ) ) {
+        fprintf ( stderr, "LOGDECODE: %s is not an event log.\n", fileName );
+        fclose ( in );
+        return 1;
+    }
+
+    while ( ( count = fread ( records, sizeof ( EventRecord ), EVENT_LOG_BATCH, in ) ) > 0 ) {
+        for ( i = 0; i < count; ++i ) {
+            printEvent ( stdout, &records[i] );
+        }
+    }
+
+    fclose ( in );
+    return 0;
+}
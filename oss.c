@@ -9,21 +9,94 @@
 //  and manage memory request from USER processes. See user.c for more info.
 
 #include "header.h"
+#include "pager.h"
+#include "trace.h"
+#include "sweep.h"
+#include "disk.h"
+#include "eventlog.h"
+#include "eventqueue.h"
+#include "workload.h"
+#include "histogram.h"
+#include "phasetime.h"
+
+#include <pthread.h>
+#include <semaphore.h>
 
 
 /* Global Variables */
 // General variables
 const int READ = 0;
 const int WRITE = 1;
-const int MAX_PROCESSES = 18;
-const int MEMORY = 256;
+const int DEFAULT_PROCESSES = 18;
 const int KILL_TIME = 2;
+
+// Simulated time (ns) charged for finding a page's frame: a TLB hit, each page table entry read by a
+//  page walk, and a page fault.
+const int TLB_HIT_TIME = 1;
+const int WALK_TIME = 10;
+
+// Simulated time (ns) to map a shared segment page another process already has loaded (a minor fault), and to
+//  copy a copy-on-write page when it is written.
+const int MINOR_FAULT_TIME = 500;
+const int COPY_TIME = 2000;
+
+// Simulated disk time (ns) to read a page in on a fault, and to write a dirty page back before its frame
+//  is reused. Both are queued on the disk, see disk.c.
+const int FAULT_TIME = 150000;
+const int WRITEBACK_TIME = 150000;
+const int WRITEBACK_BATCH_TIME = 10000;  // Each further page of a page cleaner batch. The batch goes to consecutive swap
+                                        //  slots, so after the first page it only costs the transfer.
+const int READAHEAD_TIME = 10000;       // A page read ahead right after the page before it, which is the next swap slot.
 int maxCurrentProcesses = 0;
+int maxTotalProcesses = 100;    // Guard value for the max number of processes that can be created over the course of the program.
 pid_t pid;
 
-// Logfile info
+// Settings passed to USER through execl.
+char transportBuffer[2];
+char batchBuffer[4];
+char pageSizeBuffer[12];
+char pagesBuffer[12];
+char workersBuffer[4];
+char poolBuffer[2];
+char *workloadSpec = DEFAULT_WORKLOAD;     // Which page each USER reference goes to (oss -W, see workload.h).
+
+// Pre-forked USER pool (oss -F). One USER per PCB slot is forked at startup and runs one simulated process after
+//  another: creating a process sends the slot's USER a start message with a new logical PID, and a terminated
+//  process just frees its slot. Logical PIDs start above the largest PID Linux hands out (2^22), so they can't be
+//  mistaken for a real process or a message type already in use.
+bool poolMode = false;
+pid_t *poolPids;                // Real PID of the USER serving each PCB slot.
+long nextPoolPid = 10000000;
+
+int batchSize = 1;              // Number of references USER sends per request. 1 means one Message per reference.
+
+// Memory geometry (oss -f, -n, -z). USER is given the page size and pages per process.
+int numberOfFrames = DEFAULT_FRAMES;
+int pagesPerProcess = DEFAULT_PAGES_PER_PROCESS;
+int pageSize = DEFAULT_PAGE_SIZE;
+
+// Sharing (oss -H, -k). The first sharedPages pages of every process are one shared segment, and forkPercent
+//  percent of the processes created are forks of a running process in the same shard, sharing its loaded pages
+//  copy-on-write (see pagerFork).
+int sharedPages = 0;
+int forkPercent = 0;
+
+// Huge pages (oss -G). Regions of hugePages pages that a process keeps loaded and referencing are promoted to one
+//  huge page each (see pager.h). Promoting a region whose pages aren't already in a run of frames costs a copy of
+//  each page (COPY_TIME), charged to the reference that ended the process's working set window.
+int hugePages = 0;
+
+// Page table backend (oss -P) and TLB (oss -L entries,ways).
+char *pageTableName = "flat";
+int tlbEntries = DEFAULT_TLB_ENTRIES;
+int tlbWays = DEFAULT_TLB_WAYS;
+
+// Logfile info. program.log gets the run summary and report. Every process, hit, fault and disk event goes
+//  to the binary event log instead (see eventlog.c); ./logdecode turns it into text.
 FILE *fp;
 char logName[15] = "program.log";
+char eventLogName[15] = "program.events";
+EventLog *eventLog;             // NULL when events aren't logged (a replay).
 
 // Statistic trackers
 int totalProcessesCreated = 0;
@@ -31,52 +104,133 @@ int totalMemoryRequests = 0;
 int totalPageFaults = 0;
 float memoryAccessesPerSecond = 0;
 float pageFaultsPerMemoryAccess = 0;
-int totalRuntime = 0;
+double totalRuntime = 0;        // Simulated seconds.
+struct timespec startTime;      // Real time the main loop started. Used for the wall-clock request rate.
+struct timespec endTime;        // Real time the main loop ended. Left at zero if the run was cut short by a signal.
+Histogram latency;              // Simulated ns from USER sending a request to OSS answering it, once per reference.
+char *resultsFile = NULL;       // File the report is also appended to as a CSV line (oss -o), for the benchmark.
+volatile sig_atomic_t dumpRequested = 0;        // SIGUSR1 was received. The main thread prints the timings.
+volatile sig_atomic_t cleaningUp = 0;           // cleanUpResources has started. It only ever runs once.
 
 
-/* Structures */
-// Process Control Block
-// Structure to represent the process control block. New processes can be created as long as the block is not full at the
-//    time. Each instance of a Process will be stored in an array the size of MAX_PROCESSES.
-typedef struct {
-    int pageTable[32];
-} Process;
+/* Memory Management */
+// Frame table, PCB and replacement policy. Set up in main once the number of PCB slots is known.
+//  See pager.c. pager is the one the current thread uses (its shard's, with worker threads).
+Pager **pagerGroup;
+__thread Pager *pager;
+int *pidArray;                  // PIDs of the active USER processes by PCB index.
+int activeProcesses = 0;        // Number of entries in pidArray in use.
 
-// Frame Table
-// Structure to help define an the OSS's frame table. Each instance will represent a frame in the frame table.
-//    OSS will create a an array of 256 frames in main to represent the frame table.
-typedef struct {
-    int pid;
-    int occupiedBit;
-    int dirtyBit;
-    int referenceBit;
-    int processPage;
-} Frame;
-
-// Queue member
-// Structure to represent a queue.
-typedef struct {
-    int front;
-    int rear;
-    int size;
-    unsigned capacity;
-    int * array;
-} Queue;
+// Page fault I/O. A process that faults is parked on the disk's wait queue and its response is kept in
+//  parkedResponses (one slot per PCB index) until the simulated clock passes the time its I/O is done.
+Disk *disk;
+char *parkedResponses;
+size_t parkedResponseSize;
+__thread unsigned long long faultCompletion;    // When the I/O for the current request finishes, 0 if it had no fault.
+
+// Discrete-event queue (see eventqueue.c). Process creation, page fault I/O completions and statistics samples
+//  are scheduled on it, and whichever thread finds one due runs it. When no USER can run, the clock jumps
+//  straight to the next event.
+enum { SPAWN_EVENT = 1, DISK_DONE_EVENT, SAMPLE_EVENT, CLEAN_EVENT };
+const unsigned long long SAMPLE_INTERVAL = 1000000000ULL;  // Simulated time between statistics samples.
+EventQueue *events;
+sem_t runFinished;              // Posted once the last process is created. The main thread waits on it with -w.
+
+// Working sets and admission control (oss -A). The pager measures each process's working set over a window of
+//  its own references (see Pager). With -A a process is only created while the working sets of the active ones
+//  plus its own (their mean) fit in the frame table. Otherwise it is tried again at the next spawn time, like
+//  when the PCB is full, instead of pushing every process into thrashing.
+#define DEFAULT_WORKING_SET_WINDOW 500
+int workingSetWindow = DEFAULT_WORKING_SET_WINDOW;     // References.
+bool admissionControl = false;
+uint64_t deferredSince = 0;     // When the current wait for room started, 0 if there isn't one.
+long deferredSpawns = 0;
+uint64_t deferredTime = 0;
+long peakWorkingSetTotal = 0;   // Summed working sets, checked at every attempt to create a process.
+double summedWorkingSets = 0;   // Over every attempt, for the mean working set per process.
+long sampledProcesses = 0;
+int *admittedEstimate;          // Working set each PCB slot's process counts until its first window ends.
+
+// Page cleaner (oss -C batch,high,low). It wakes up on the event queue and writes back a batch of up to batch
+//  dirty pages of one process (see pagerClean) whenever the disk is idle and more than low percent of the frames
+//  are dirty, or, with more than high percent dirty, as soon as its last batch is done even if the disk is busy.
+//  A frame it has cleaned can be given to another page with only a read, where a dirty one needs a write first,
+//  and a batch costs a lot less disk time than writing its pages back one eviction at a time. Off unless -C is
+//  given.
+#define DEFAULT_CLEANER_HIGH 50
+#define DEFAULT_CLEANER_LOW 10
+const unsigned long long CLEAN_INTERVAL = 100000ULL;    // Simulated time between looks while there is nothing to do.
+int cleanerBatch = 0;           // Pages.
+int cleanerHigh = DEFAULT_CLEANER_HIGH;     // Percent of the frames.
+int cleanerLow = DEFAULT_CLEANER_LOW;
+int *cleanerPages;              // Scratch space for pagerClean.
+long cleanedPages = 0;
+long cleanerBatches = 0;
+long evictionWritebacks = 0;    // Dirty pages written back because their frame was taken for another page.
+
+// Read-ahead (oss -a, see prefetch.h). On a page fault the pager also loads the pages its prefetcher predicts,
+//  and their reads are queued on the disk behind the faulting page's. A process that references one before it
+//  is in waits for it like a page fault, but no longer than the read has left to go.
+char *prefetchSpec = "none";
+unsigned long long *frameReady;     // By frame, when the read of a page read ahead into it is done. Under ossLock.
+long prefetchReads = 0;
+__thread unsigned int clockDebt;                // Simulated time charged to the current request, added to the clock when it is done.
+
+// Worker threads (oss -w). Worker w serves the PCB slots i with i % numberOfWorkers == w, using shard w of
+//  the pager group. ossLock covers the event queue, the disk and pidArray. The clock (simclock.h) and the log
+//  don't need it. The main thread blocks stopSignals while it holds ossLock (workers never take a signal).
+int numberOfWorkers = 1;
+pthread_t *workers;
+bool stopWorkers = false;
+__thread int workerShard;
+pthread_mutex_t ossLock = PTHREAD_MUTEX_INITIALIZER;
+sigset_t stopSignals;
+
+// Replacement policy (oss -p). Second chance unless another one is picked. A replay can be given a
+//  comma-separated list to simulate several policies over the same trace at once.
+char policyList[128] = "sc";
+char *sweepList = NULL;         // Frame table sizes for a sweep.
+
+// Traces (oss -t to record, oss -R to replay).
+char *traceFile = NULL;         // File USER records its references to.
+char *replayFile = NULL;        // File replayed in place of running USER processes.
+SimClock replayClock;           // Simulated clock used during replay since there is no shared memory.
 
 /* Function prototypes */
 // General functions
-void manageClock ( unsigned int clock[] );
+void runDueEvents ( void );
+bool spawnProcess ( void );
+void forkProcess ( int blockIndex );
+pid_t forkUser ( int blockIndex, int processNumber );
+void reapChildren ( int sig_num );
+void requestDump ( int sig_num );
+void dumpTimings ( void );
+void sampleStatistics ( void );
+void runCleaner ( void );
+void parkProcess ( void );
+void publishCounts ( void );
+bool admitProcess ( int blockIndex );
+long workingSetTotal ( void );
+void resumeProcess ( int blockIndex );
+uint64_t sentTime ( const unsigned int time[] );
 void cleanUpResources ( void );
+void recordLatency ( void );
+void writeResults ( double wallSeconds );
 void printReport ( void );
-
-// Queue prototypes
-Queue* createQueue ( unsigned capacity );
-int isFull ( Queue* queue );
-int isEmpty ( Queue* queue );
-void enqueue ( Queue* queue, int item );
-int dequeue ( Queue* queue );
-int front ( Queue* queue );
-int rear ( Queue* queue );
+const char* runMode ( void );
+void serveRequest ( void );
+bool receiveRequest ( void );
+void sendResponse ( long type );
+void* workerThread ( void* arg );
+void stopWorkerThreads ( void );
+bool handleMemoryRequest ( void );
+int setupIPC ( void );
+int replayTrace ( void );
+void* replayThread ( void* arg );
+int sweepTrace ( void );
+void useTraceGeometry ( const TraceMap* trace );
+const PagerConfig* pagerConfig ( const char* policy );
+void stopUsers ( void );
 
 
 
@@ -87,29 +241,125 @@ int rear ( Queue* queue );
 int main ( int argc, char *argv[] ) {
     
     // General variables
-    int i, j;                               // Control variables for loop logic.
-    maxCurrentProcesses = MAX_PROCESSES;    // Default value for the max number of processes that can be running at one time.
-    int maxTotalProcesses = 100;            // Guard value for the max number of processes that can be created over the course of the program.
+    int i;                                  // Control variable for loop logic.
+    maxCurrentProcesses = DEFAULT_PROCESSES;    // Default value for the max number of processes that can be running at one time.
+    sigset_t oldMask;
     
     // Log file setup
     fp = fopen( logName, "w+" );    // Opens up log file for writing to. File will be overwritten during each new run of the program.
-    int numberOfLines = 0;          // Tracks the number of lines in the log file.
-    bool keepLogging = true;        // Flag to show when the log file has reached its line limit.
     
     
     /* Getopts */
     // Loop to implement getopt to get any command-line options and/or arguments.
     // Option -s requires ant argument.
     int opt = 0;    // Controls the getopt loop
-    while ( ( opt = getopt ( argc, argv, "hs:" ) ) != -1 ) {
+    while ( ( opt = getopt ( argc, argv, "a:A:b:C:f:FG:hH:k:L:n:o:p:P:rR:s:S:t:w:W:z:" ) ) != -1 ) {
         switch ( opt ) {
+            // Specify the prefetcher.
+            case 'a':
+                prefetchSpec = optarg;
+                break;
+                
+            // Turn on admission control, with the working set window in references.
+            case 'A':
+                workingSetWindow = atoi ( optarg );
+                if ( workingSetWindow < 1 ) {
+                    workingSetWindow = DEFAULT_WORKING_SET_WINDOW;
+                }
+                admissionControl = true;
+                break;
+                
+            // Specify the number of memory references USER batches into a single request.
+            case 'b':
+                batchSize = atoi ( optarg );
+                if ( batchSize < 1 ) {
+                    batchSize = 1;
+                } else if ( batchSize > MAX_BATCH ) {
+                    batchSize = MAX_BATCH;
+                }
+                break;
+                
+            // Turn on the page cleaner, with its batch size and optionally the dirty frame percentages it cleans
+            //  at regardless of the disk and while the disk is idle.
+            case 'C':
+                cleanerBatch = atoi ( optarg );
+                if ( cleanerBatch < 1 ) {
+                    cleanerBatch = 1;
+                }
+                if ( strchr ( optarg, ',' ) != NULL ) {
+                    cleanerHigh = atoi ( strchr ( optarg, ',' ) + 1 );
+                    cleanerLow = strchr ( strchr ( optarg, ',' ) + 1, ',' ) != NULL ? atoi ( strchr ( strchr ( optarg, ',' ) + 1, ',' ) + 1 ) : cleanerHigh / 5;
+                }
+                if ( cleanerHigh < 0 || cleanerHigh > 100 ) {
+                    cleanerHigh = DEFAULT_CLEANER_HIGH;
+                }
+                if ( cleanerLow < 0 || cleanerLow > cleanerHigh ) {
+                    cleanerLow = cleanerHigh;
+                }
+                break;
+                
+            // Specify the number of frames in the frame table.
+            case 'f':
+                numberOfFrames = atoi ( optarg );
+                if ( numberOfFrames < 1 ) {
+                    numberOfFrames = DEFAULT_FRAMES;
+                }
+                break;
+                
+            // Specify the pages in a huge page.
+            case 'G':
+                hugePages = atoi ( optarg );
+                break;
+                
+            // Specify the pages in the shared segment.
+            case 'H':
+                sharedPages = atoi ( optarg );
+                if ( sharedPages < 0 ) {
+                    sharedPages = 0;
+                }
+                break;
+                
+            // Specify the percent of processes created by forking a running one.
+            case 'k':
+                forkPercent = atoi ( optarg );
+                if ( forkPercent < 0 ) {
+                    forkPercent = 0;
+                } else if ( forkPercent > 100 ) {
+                    forkPercent = 100;
+                }
+                break;
+                
             // Display the help message.
             case 'h':
                 printf ( "Program: ./oss\n" );
                 printf ( "Options:\n" );
+                printf ( "\t-a : pages to read ahead on a page fault (%s, default none)\n", prefetcherNames() );
+                printf ( "\t-A : only create a process while the working sets fit in the frame table, measured over the given number of references (default window %d)\n", DEFAULT_WORKING_SET_WINDOW );
+                printf ( "\t-b : number of memory references USER sends per request (1-%d, default 1)\n", MAX_BATCH );
+                printf ( "\t-C : write dirty pages back ahead of time, in batches of up to the given number of pages. Optionally followed by\n" );
+                printf ( "\t     the percent of frames dirty it cleans at even with the disk busy, and while it is idle, e.g. 16,%d,%d (the default)\n", DEFAULT_CLEANER_HIGH, DEFAULT_CLEANER_LOW );
+                printf ( "\t-f : number of frames in the frame table (default %d)\n", DEFAULT_FRAMES );
+                printf ( "\t-F : pre-fork one USER per PCB slot and reuse it for every process created in that slot\n" );
+                printf ( "\t-G : pages in a huge page, a power of two. Regions that size that a process keeps loaded and referencing are\n" );
+                printf ( "\t     promoted to huge pages (default 0, base pages only)\n" );
                 printf ( "\t-h : display help message (currently viewing)\n" );
-                printf ( "\t-s : specify the maximum number of user processes allowed by the system at any given time\n" );
-                printf ( "\tNote: -s requires an argument\n" );
+                printf ( "\t-H : number of pages at the start of every process's address space that are one shared segment (default 0)\n" );
+                printf ( "\t-k : percent of processes created as a fork of a running process, sharing its pages copy-on-write (default 0)\n" );
+                printf ( "\t-L : TLB entries per process and ways, e.g. 64,4 (default %d,%d, 0 for no TLB)\n", DEFAULT_TLB_ENTRIES, DEFAULT_TLB_WAYS );
+                printf ( "\t-n : number of pages in each process's address space (1-%d, default %d)\n", MAX_PAGES_PER_PROCESS, DEFAULT_PAGES_PER_PROCESS );
+                printf ( "\t-o : also append the report to the given file as a CSV line (see ./benchmark)\n" );
+                printf ( "\t-p : page replacement policy to use (%s, default sc)\n", policyNames() );
+                printf ( "\t     with -R this can be a comma-separated list, simulated in parallel over the same trace\n" );
+                printf ( "\t-P : page table backend to use (%s, default flat)\n", pageTableNames() );
+                printf ( "\t-r : use the shared-memory ring transport instead of the message queue\n" );
+                printf ( "\t-R : replay the given trace file in-process instead of running USER processes\n" );
+                printf ( "\t-s : specify the maximum number of user processes allowed by the system at any given time (1-%d, default %d)\n", MAX_PAGER_PROCESSES, DEFAULT_PROCESSES );
+                printf ( "\t-S : with -R, a comma-separated list of frame table sizes. Every policy in -p is simulated at each size\n" );
+                printf ( "\t-t : have every USER record its memory references to the given trace file\n" );
+                printf ( "\t-w : number of OSS worker threads, each serving its own share of the PCB (1-%d, default 1)\n", RING_MAX_SHARDS );
+                printf ( "\t-W : workload USER generates references from (%s, default %s)\n", workloadNames(), DEFAULT_WORKLOAD );
+                printf ( "\t-z : page size in bytes (default %d)\n", DEFAULT_PAGE_SIZE );
+                printf ( "\tNote: every option except -F, -h and -r requires an argument\n" );
                 printf ( "\tNote: oss does not require any options. Default values are provided if not specified.\n" );
                 printf ( "Example usage:\n" );
                 printf ( "\t./oss -s 3\n" );
@@ -118,11 +368,92 @@ int main ( int argc, char *argv[] ) {
                 exit ( 0 );
                 break;
                 
+            // Specify the TLB size and associativity.
+            case 'L':
+                tlbEntries = atoi ( optarg );
+                tlbWays = strchr ( optarg, ',' ) != NULL ? atoi ( strchr ( optarg, ',' ) + 1 ) : tlbEntries;
+                break;
+                
+            // Specify the number of pages in each process's address space.
+            case 'n':
+                pagesPerProcess = atoi ( optarg );
+                if ( pagesPerProcess < 1 ) {
+                    pagesPerProcess = DEFAULT_PAGES_PER_PROCESS;
+                } else if ( pagesPerProcess > MAX_PAGES_PER_PROCESS ) {
+                    pagesPerProcess = MAX_PAGES_PER_PROCESS;
+                }
+                break;
+                
+            // Append the results to a CSV file.
+            case 'o':
+                resultsFile = optarg;
+                break;
+                
+            // Specify the page replacement policy.
+            case 'p':
+                strncpy ( policyList, optarg, sizeof ( policyList ) - 1 );
+                break;
+                
+            // Specify the page table backend.
+            case 'P':
+                pageTableName = optarg;
+                break;
+                
+            // Use the shared-memory ring transport instead of the message queue.
+            case 'r':
+                transport = TRANSPORT_RING;
+                break;
+                
+            // Use a pre-forked pool of USER processes.
+            case 'F':
+                poolMode = true;
+                break;
+                
+            // Replay a trace instead of running USER processes.
+            case 'R':
+                replayFile = optarg;
+                break;
+                
             // Specify the maximum number of user process to be running at one time.
             case 's':
                 maxCurrentProcesses = atoi ( optarg++ );
-                if ( maxCurrentProcesses > MAX_PROCESSES ) {
-                    maxCurrentProcesses = MAX_PROCESSES;
+                if ( maxCurrentProcesses < 1 ) {
+                    maxCurrentProcesses = DEFAULT_PROCESSES;
+                } else if ( maxCurrentProcesses > MAX_PAGER_PROCESSES ) {
+                    maxCurrentProcesses = MAX_PAGER_PROCESSES;
+                }
+                break;
+                
+            // Specify the frame table sizes for a sweep.
+            case 'S':
+                sweepList = optarg;
+                break;
+                
+            // Specify the file USER processes record their memory references to.
+            case 't':
+                traceFile = optarg;
+                break;
+                
+            // Specify the number of worker threads.
+            case 'w':
+                numberOfWorkers = atoi ( optarg );
+                if ( numberOfWorkers < 1 ) {
+                    numberOfWorkers = 1;
+                } else if ( numberOfWorkers > RING_MAX_SHARDS ) {
+                    numberOfWorkers = RING_MAX_SHARDS;
+                }
+                break;
+                
+            // Specify the workload.
+            case 'W':
+                workloadSpec = optarg;
+                break;
+                
+            // Specify the page size.
+            case 'z':
+                pageSize = atoi ( optarg );
+                if ( pageSize < 1 ) {
+                    pageSize = DEFAULT_PAGE_SIZE;
                 }
                 break;
                 
@@ -131,10 +462,42 @@ int main ( int argc, char *argv[] ) {
         }
     } // End of getopts
     
+    // Every worker needs at least one PCB slot.
+    if ( numberOfWorkers > maxCurrentProcesses ) {
+        numberOfWorkers = maxCurrentProcesses;
+    }
+    
+    if ( sweepList != NULL && replayFile == NULL ) {
+        fprintf ( stderr, "OSS: A sweep (-S) needs a trace to replay (-R).\n" );
+        return 1;
+    }
+    
+    // A huge page is a run of frames found by the buddy allocator, so it has to be a power of two pages, and fit
+    //  in an address space (a replay takes its pages per process from the trace).
+    if ( hugePages != 0 && ( hugePages < 2 || ( hugePages & ( hugePages - 1 ) ) != 0 || ( replayFile == NULL && hugePages > pagesPerProcess ) ) ) {
+        fprintf ( stderr, "OSS: A huge page (-G) has to be a power of two from 2 up to the pages per process (%d).\n", pagesPerProcess );
+        return 1;
+    }
+    
+    // The TLB is cut into entries / ways sets of ways entries each, so the ways have to divide the entries evenly
+    //  or the leftover entries would silently go unused.
+    if ( tlbEntries < 0 || ( tlbEntries > 0 && ( tlbWays < 1 || tlbEntries % tlbWays != 0 ) ) ) {
+        fprintf ( stderr, "OSS: A TLB (-L) needs entries that are a multiple of its ways, e.g. 64,4 (or 0 for no TLB).\n" );
+        return 1;
+    }
+    
+    // Only a replay can run more than one policy.
+    if ( replayFile == NULL && strchr ( policyList, ',' ) != NULL ) {
+        fprintf ( stderr, "OSS: More than one replacement policy can only be used with -R.\n" );
+        return 1;
+    }
+    
     
     /* Signal Handling */
-    // Sets the timer alarm based on the value of KILL_TIME
-    alarm ( KILL_TIME );
+    // Sets the timer alarm based on the value of KILL_TIME. A replay runs to the end of the trace instead.
+    if ( replayFile == NULL ) {
+        alarm ( KILL_TIME );
+    }
     
     // Catch signals for ctrl-c input or other early termination signals.
     if ( signal ( SIGINT, sig_handle ) == SIG_ERR ) {
@@ -148,330 +511,191 @@ int main ( int argc, char *argv[] ) {
         return 1;
     }
     
+    // Reap USER processes as they exit instead of waiting for each one in the main loop.
+    struct sigaction childAction;
+    memset ( &childAction, 0, sizeof ( childAction ) );
+    childAction.sa_handler = reapChildren;
+    childAction.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigemptyset ( &childAction.sa_mask );
+    if ( sigaction ( SIGCHLD, &childAction, NULL ) == -1 ) {
+        perror ( "OSS: child signal failed." );
+        return 1;
+    }
     
-    /* Shared Memory */
-    // Create shared memory block for simulated system clock.
-    if ( ( shmClockID = shmget ( shmKey, ( 2 * ( sizeof ( unsigned int ) ) ), IPC_CREAT | 0666 ) ) == -1 ) {
-        perror ( "OSS: Failure to create shared memory space for simulated clock." );
+    // SIGUSR1 prints the latency and phase timing so far to stderr. It interrupts msgrcv so the dump doesn't wait
+    //  for the next request.
+    struct sigaction dumpAction;
+    memset ( &dumpAction, 0, sizeof ( dumpAction ) );
+    dumpAction.sa_handler = requestDump;
+    sigemptyset ( &dumpAction.sa_mask );
+    if ( sigaction ( SIGUSR1, &dumpAction, NULL ) == -1 ) {
+        perror ( "OSS: dump signal failed." );
         return 1;
     }
     
-    // Attach to and initialize shared memory.
-    if ( ( shmClock = (int *) shmat ( shmClockID, NULL, 0 ) ) < 0 ) {
-        perror ( "OSS: Failure to attach to shared memory space for simulated clock." );
+    // Make sure USER will understand the workload before anything is started.
+    Workload workloadCheck;
+    if ( !createWorkload ( &workloadCheck, workloadSpec, pagesPerProcess ) ) {
+        fprintf ( stderr, "OSS: Unknown workload %s. Choose from: %s.\n", workloadSpec, workloadNames() );
         return 1;
     }
-    shmClock[0] = 0;    // Seconds value for the simulated clock.
-    shmClock[1] = 1;    // Nanoseconds value for the simulated clock.
+    destroyWorkload ( &workloadCheck );
     
-
-    /* Message Queue */
-    // Create the message queue used for IPC.
-    if ( ( messageID = msgget ( messageKey, IPC_CREAT | 0666 ) ) == -1 ) {
-        perror ( "OSS: Failure to create the message queue." );
+    // The same for the prefetcher, which the pager creates.
+    Prefetcher *prefetchCheck;
+    if ( prefetcherWanted ( prefetchSpec ) ) {
+        if ( ( prefetchCheck = createPrefetcher ( prefetchSpec, 1, pagesPerProcess ) ) == NULL ) {
+            fprintf ( stderr, "OSS: Unknown prefetcher %s. Choose from: %s (n from 1 to %d).\n", prefetchSpec, prefetcherNames(), MAX_PREFETCH );
+            return 1;
+        }
+        destroyPrefetcher ( prefetchCheck );
+    }
+    
+    // Sharing needs a page table that can map a frame more than once.
+    PageTable *pageTableCheck;
+    if ( ( sharedPages > 0 || forkPercent > 0 ) && ( pageTableCheck = createPageTable ( pageTableName, 1, pagesPerProcess, 1, 0 ) ) != NULL ) {
+        if ( !pageTableCheck->sharesFrames ) {
+            fprintf ( stderr, "OSS: The %s page table has one entry per frame, so pages can't be shared (-H, -k). Use flat or radix.\n", pageTableName );
+            destroyPageTable ( pageTableCheck );
+            return 1;
+        }
+        destroyPageTable ( pageTableCheck );
+    }
+    
+    
+    /* Shared Memory and Message Queue */
+    // A replay has no USER processes, so none of the IPC is set up. The simulated clock is kept in OSS
+    //  and the PCB is sized from the trace (see useTraceGeometry).
+    if ( replayFile != NULL ) {
+        shmClock = &replayClock;
+        clockSet ( shmClock, 1 );
+    } else if ( setupIPC() != 0 ) {
         return 1;
     }
     
+    // Create the trace file USER processes will append to.
+    if ( traceFile != NULL && !traceCreate ( traceFile, maxCurrentProcesses, pagesPerProcess ) ) {
+        perror ( "OSS: Failure to create the trace file." );
+        return 1;
+    }
+    sprintf( transportBuffer, "%d", transport );
+    sprintf( batchBuffer, "%d", batchSize );
+    sprintf( pageSizeBuffer, "%d", pageSize );
+    sprintf( pagesBuffer, "%d", pagesPerProcess );
+    sprintf( workersBuffer, "%d", numberOfWorkers );
+    sprintf( poolBuffer, "%d", poolMode ? 1 : 0 );
+    if ( traceFile == NULL ) {
+        traceFile = "";     // USER treats an empty name as no tracing.
+    }
     
-    /* Setup for main loop */
-    // Create a queue large enough to hold all of the frames in the frame table at once.
-    Queue* frameQueue = createQueue ( MEMORY );
     
+    /* Setup for main loop */
     // Array to store the pids of any currently active processes. Updated by OSS.
-    //  After initializing, set the value at each index to -1.
-    int pidArray[maxCurrentProcesses];
-    for ( i = 0; i < maxCurrentProcesses; ++i ) {
-        pidArray[i] = -1;
+    //  Every index starts at 0.
+    pidArray = (int *) calloc ( maxCurrentProcesses, sizeof ( int ) );
+    
+    // Replay the trace and finish without ever entering the main loop. The replay sets up its own pagers.
+    if ( replayFile != NULL ) {
+        return sweepList != NULL ? sweepTrace() : replayTrace();
+    }
+    
+    // Frame table, PCB and replacement policy. One pager per worker thread, sharing the frame table.
+    pagerGroup = (Pager **) malloc ( numberOfWorkers * sizeof ( Pager* ) );
+    if ( !createPagerGroup ( pagerConfig ( policyList ), numberOfWorkers, pagerGroup ) ) {
+        fprintf ( stderr, "OSS: Unknown page replacement policy %s or page table %s (or not enough memory for %d frames). Choose from: %s and %s.\n", policyList, pageTableName, numberOfFrames, policyNames(), pageTableNames() );
+        free ( pagerGroup );
+        pagerGroup = NULL;
+        cleanUpResources();
+        return 1;
     }
+    pager = pagerGroup[0];
     
-    // Frame Table
-    // After initializing, set the occupied bit to 0 for each index to start off to show every index
-    //  is unoccupied.
-    Frame frameTable[MEMORY];
-    for ( i = 0; i < MEMORY; ++i ) {
-        frameTable[i].occupiedBit = 0;
+    // Event log and its writer thread.
+    if ( ( eventLog = openEventLog ( eventLogName ) ) == NULL ) {
+        perror ( "OSS: Failure to create the event log." );
+        cleanUpResources();
+        return 1;
     }
     
-    // Process Control Block
-    // After initializing, set the page value for each index's page table to -1.
-    Process pcb[maxCurrentProcesses];
-    for ( i = 0; i < maxCurrentProcesses; ++i ) {
-        for ( j = 0; j < 32; ++j ) {
-            pcb[i].pageTable[j] = -1;
-        }
+    // Paging disk and a response slot for every process that could be waiting on it.
+    disk = createDisk();
+    frameReady = (unsigned long long *) calloc ( numberOfFrames, sizeof ( unsigned long long ) );
+    parkedResponseSize = batchSize > 1 ? batchMessageSize ( batchSize ) : sizeof ( Message );
+    parkedResponses = (char *) malloc ( maxCurrentProcesses * parkedResponseSize );
+    
+    // Event queue, with room for an I/O completion for every PCB slot plus the next process, sample and page
+    //  cleaner wake-up. The first process is created right away.
+    events = createEventQueue ( maxCurrentProcesses + 3 );
+    scheduleEvent ( events, 0, SPAWN_EVENT, -1 );
+    scheduleEvent ( events, SAMPLE_INTERVAL, SAMPLE_EVENT, -1 );
+    if ( cleanerBatch > 0 ) {
+        cleanerPages = (int *) malloc ( cleanerBatch * sizeof ( int ) );
+        scheduleEvent ( events, CLEAN_INTERVAL, CLEAN_EVENT, -1 );
     }
+    admittedEstimate = (int *) calloc ( maxCurrentProcesses, sizeof ( int ) );
+    sem_init ( &runFinished, 0, 0 );
     
-    // Various variables to be used within the main loop below.
-    bool createProcess = false;         // Flags if it is okay to create a new process.
-    bool pagePresent;                   // Flags if the page requested by USER is currently loaded in the frame table somewhere.
-    bool noEmptyFrame;                  // Flags if the frame table is currently full.
-    unsigned int newProcessTime[2] = { 0, 0 };  // Timer to set a time for a new process to be created after.
+    // The signals that stop or interrupt a run. Whatever holds them off gets them when it lets go, so a run
+    //  that ends mid-way through creating something cleans up after it is whole.
+    sigemptyset ( &stopSignals );
+    sigaddset ( &stopSignals, SIGINT );
+    sigaddset ( &stopSignals, SIGALRM );
+    sigaddset ( &stopSignals, SIGCHLD );
+    sigaddset ( &stopSignals, SIGUSR1 );
+    
+    // Fork the USER pool. Each one waits for the start message of its first process. A large pool can take
+    //  longer than KILL_TIME, so the stop signals wait until every USER is forked.
+    if ( poolMode ) {
+        poolPids = (pid_t *) calloc ( maxCurrentProcesses, sizeof ( pid_t ) );
+        pthread_sigmask ( SIG_BLOCK, &stopSignals, &oldMask );
+        for ( i = 0; i < maxCurrentProcesses; ++i ) {
+            if ( ( poolPids[i] = forkUser ( i, 0 ) ) == -1 ) {
+                perror( "OSS: Failure to fork the USER pool." );
+                cleanUpResources();
+                return 1;
+            }
+        }
+        pthread_sigmask ( SIG_SETMASK, &oldMask, NULL );
+        fprintf( fp, "Forked a pool of %d USER processes.\n", maxCurrentProcesses );
+    }
     
     fprintf( fp, "Beginning Main Loop...\n" );
     fflush( fp );
+    clock_gettime( CLOCK_MONOTONIC, &startTime );
+    phaseTimingStart();
+    statsStore ( shmStats->running, 1 );
     
-    /* Main Loop */
-    while ( totalProcessesCreated <= maxTotalProcesses ) {
-        /* 1. Check to make sure the log file has surpassed it maximum number of lines allowed.
-         If it has, close the file and set the flag to false so no more writes will be done. */
-        if ( ( keepLogging == true ) && ( numberOfLines >= 10000 ) ) {
-            printf( "Log file has reached its maximum size.\n" );
-            fprintf( fp, "Log file has reached its maximum size.\n" );
-        
-            keepLogging = false;
-        } // End of checking the log file status
-        
-        /* 2 - Check to see if it is time to create a new process (shmClock needs to have passed
-         the time stored in newProcessTime). */
-        if ( ( ( shmClock[0] == newProcessTime[0] ) && ( shmClock[1] >= newProcessTime[1] ) ) || ( shmClock[0] > newProcessTime[0] ) )  {
-            // OSS needs to find an available location in the PCB by checking the pidArray.
-            for ( i = 0; i < maxCurrentProcesses; ++i ){
-                if ( pidArray[i] == 0 ) {
-                    createProcess = true;
-                    pid = fork();   // If there was room, fork the process.
-                    
-                    break;
-                }
-            } // End of checking for room in pidArray
-        
-            // If the process was forked, manage the rest of the process creation pieces.
-            if ( createProcess == true ) {
-                // Error checking
-                if ( pid == -1 ) {
-                    perror( "OSS: Failure to fork the child process." );
-                    kill( getpid(), SIGINT );
-                }
-                // In the child process...
-                else if ( pid == 0 ) {
-                    // Create a buffer for the child's index to in the PCB to pass with execl.
-                    char indexBuffer[3];
-                    sprintf( indexBuffer, "%d", i );
-                    execl( "./user", "user", indexBuffer, NULL );
-                }
-                // In OSS...
-                else {
-                    pidArray[i] = pid;
-                    if ( keepLogging == true) {
-                        fprintf( fp, "OSS: Created Process: %d. Stored in PCB at Index: %d. Time: %d:%d.\n", pid, i, shmClock[0], shmClock[1] );
-                        fflush( fp );
-                        numberOfLines++;
-                    }
-                    
-                    totalProcessesCreated++;
-                }
-            }
-            
-            // Set a new time for the next process to be created after.
-            newProcessTime[0] = shmClock[0];
-            newProcessTime[1] = ( rand() % ( 5000000 - 1000000 + 1 ) + 1000000 ) + shmClock[1];
-            manageClock( newProcessTime );
-        } // End of child creation flow.
-        
-        /* 3 - Check for a message from a child with a memory request. */
-        msgrcv( messageID, &message, sizeof( message ), getpid(), 0 );
-        totalMemoryRequests++;  // Increase the request counter once a message is received.
-
-        /* 4 - Check for termination notice from USER. */
-        if ( message.terminate == 1 ) {
-            if ( keepLogging == true ) {
-                fprintf( fp, "OSS: Process %ld terminated at %d:%d.\n", message.pid, message.sentTime[0], message.sentTime[1] );
-                fflush( fp );
-                numberOfLines++;
-            }
-            
-            // Reset its location PID vector
-            pidArray[message.blockIndex] = 0;
-            
-            // Clear any associated frames in the frame table based on what was stored in the PCB.
-            for ( i = 0; i < 32; ++i ) {
-                if ( pcb[message.blockIndex].pageTable[i] != -1 ) {
-                    // Reset the frame that maps to this page in the process's page table.
-                    frameTable[pcb[message.blockIndex].pageTable[i]].pid = 0;
-                    frameTable[pcb[message.blockIndex].pageTable[i]].occupiedBit = 0;
-                    frameTable[pcb[message.blockIndex].pageTable[i]].dirtyBit = 0;
-                    frameTable[pcb[message.blockIndex].pageTable[i]].referenceBit = 0;
-                    frameTable[pcb[message.blockIndex].pageTable[i]].processPage = -1;
-                    
-                    // Reset the page in the process's page table
-                    pcb[message.blockIndex].pageTable[i] = -1;
-                }
-            }
-            
-            // Make sure the process terminated.
-            kill( message.pid, SIGTERM );
-            wait ( NULL );
-            
-            // If the process did terminate, then continue is used to skip the rest of the loop code and begin the next run through
-            //  since none of the below code will impact the terminated process.
-            continue;
-        } // End of checking for termination
-        
-        /* 5 - Check for page fault. Need to check search the process's page table for the correct mapping of
-         the requested page to its location in the frame table. */
-        pagePresent = false;
-        noEmptyFrame = false;
-
-        // Need to search the process's page table for the correct mapping of the requested page to its frame table index.
-        
-        // 5a - If the page is found in the frame table...(no page fault)...
-        if ( pcb[message.blockIndex].pageTable[message.pageRef] != -1 ) {
-            // Flag that the page is already loaded into a frame in the frame table.
-            pagePresent = true;
-            
-            // Reset the reference bit to 1 indicating that the frame just been referenced.
-            frameTable[pcb[message.blockIndex].pageTable[message.pageRef]].referenceBit = 1;
-            
-            // If memory request was a read...
-            if ( message.requestType == READ ) {
-                if ( keepLogging == true ) {
-                    fprintf( fp, "OSS: Process %ld requesting READ of address %d at time %d:%d.\n", message.pid, message.memoryAddress, message.sentTime[0], message.sentTime[1] );
-                    fflush( fp );
-                    numberOfLines++;
-                }
-                
-                // If the frame's dirty bit is not set...
-                if (  frameTable[pcb[message.blockIndex].pageTable[message.pageRef]].dirtyBit == 0 ) {
-                    if ( keepLogging == true ) {
-                        fprintf( fp, "OSS: Address %d in Frame %d. Giving data to Process %ld at time %d:%d.\n", message.memoryAddress, pcb[message.blockIndex].pageTable[message.pageRef], message.pid, shmClock[0], shmClock[1] );
-                        fflush( fp );
-                        numberOfLines++;
-                        
-                        shmClock[1] += 10;
-                    }
-                }
-                // If the frame's dirty bit is not set...Takes slightly longer to read since there was something
-                //  written to the address.
-                else {
-                    if ( keepLogging == true ) {
-                        fprintf( fp, "OSS: Address %d in Frame %d. Dirty bit was set. Giving data to Process %ld at time %d:%d.\n", message.memoryAddress, pcb[message.blockIndex].pageTable[message.pageRef], message.pid, shmClock[0], shmClock[1] );
-                        fflush( fp );
-                        numberOfLines++;
-                        
-                        shmClock[1] += 15;
-                    }
-                }
-            }
-            
-            // If memory request was a write...
-            if ( message.requestType == WRITE ) {
-                if ( keepLogging == true ) {
-                    fprintf( fp, "OSS: Process %ld requesting WRITE to address %d at time %d:%d.\n", message.pid, message.memoryAddress, message.sentTime[0], message.sentTime[1] );
-                    fflush( fp );
-                    
-                    fprintf( fp, "OSS: Address %d in Frame %d. Giving data to Process %ld at time %d:%d.\n", message.memoryAddress, pcb[message.blockIndex].pageTable[message.pageRef], message.pid, shmClock[0], shmClock[1] );
-                    fflush( fp );
-                    numberOfLines += 2;
-                    
-                    shmClock[1] += 10;
-                }
-            }
-            
-            manageClock( shmClock );
-        } // End of 5a (no page fault)
-        
-        // 5b - if the page is not found in the frame table...(page fault/second-chance algorithm)...
-        if ( !pagePresent ) {
-            totalPageFaults++;
-            
-            // Since the page was not loaded anywhere in the frame table, need to first check to see if
-            //  there is room to load a new page without unloading another.
-            for ( i = 0; i < MEMORY; ++i ) {
-                // If an unoccupied frame is found, load the page info into the frame.
-                if ( frameTable[i].occupiedBit == 0 ) {
-                    frameTable[i].pid = message.pid;
-                    frameTable[i].occupiedBit = 1;
-                    frameTable[i].dirtyBit = 0;
-                    frameTable[i].referenceBit = 1;
-                    frameTable[i].processPage = pcb[message.blockIndex].pageTable[message.pageRef];
-                   
-                    // Place frame index into queue to track how long it has been in the system.
-                    enqueue( frameQueue, i );
-                    
-                    // Store frame index in the process's page to correctly map its location in the frame table.
-                    pcb[message.blockIndex].pageTable[message.pageRef] = i;
-                } else if ( i == ( MEMORY + 1 ) ) {
-                    noEmptyFrame = true;
-                }
-            } // End of looking for an empty frame.
-        
-            if ( noEmptyFrame ) {
-                // This will hold the frame that will eventually be replaced by the new frame info.
-                int removedFrame = 0;
-                
-                // Temporary frame value to hold data while going through algorithm.
-                int possibleFrame;
-                
-                // Flag to control algorithm.
-                bool searching = true;
-                
-                do {
-                    possibleFrame = front( frameQueue );
-                    dequeue( frameQueue );
-                    
-                    // If frame is dequeued with a reference bit == 0, then it is the oldest-populated frame
-                    //  having been reference the least-recently, so it is chosen to be replaced.
-                    if ( frameTable[possibleFrame].referenceBit == 0 ) {
-                        removedFrame = possibleFrame;
-                        searching = false;
-                        break;
-                    }
-                    
-                    // If frame is dequeued with a reference bit == 1, then it has not been hit by the selection
-                    //  algorithm yet and is given a second chance.
-                    if ( frameTable[possibleFrame].referenceBit == 1 ) {
-                        frameTable[possibleFrame].referenceBit = 0;
-                    }
-                    
-                    // If the frame didn't get removed, place it back in the queue and run through the loop again.
-                    enqueue( frameQueue, possibleFrame );
-                } while ( searching );
-                
-                if ( keepLogging ) {
-                    fprintf( fp, "OSS: Clearing frame %d and swapping in Process %ld Page %d.\n", removedFrame, message.pid, message.pageRef );
-                    fflush( fp );
-                    numberOfLines++;
-                }
-                
-                // Update the page for the process whose page info was just unloaded.
-                int tempIndex;
-                int tempFrameIndex;
-                for ( i = 0; i < maxCurrentProcesses; ++i ) {
-                    if ( pidArray[i] == frameTable[removedFrame].pid ) {
-                        tempIndex = i;
-                        break;
-                    }
-                }
-                tempFrameIndex = frameTable[removedFrame].processPage;
-                pcb[tempIndex].pageTable[tempFrameIndex] = -1;
-                
-                // Update frame with info of new page.
-                if ( message.requestType == 0 ) {
-                    frameTable[removedFrame].dirtyBit = 0;
-                } else {
-                    frameTable[removedFrame].dirtyBit = 1;
-                }
-                
-                frameTable[removedFrame].pid = message.pid;
-                frameTable[removedFrame].occupiedBit = 1;
-                frameTable[removedFrame].processPage = message.pageRef;
-                frameTable[removedFrame].referenceBit = 1;
-            } // End of selecting the frame to replace
-        
-            shmClock[1] += 150000;
-            manageClock( shmClock );
-        
-        } // End of 5b (second chance algorithm)
+    // Start the worker threads. They never take a signal, so the main thread can't be interrupted by one
+    //  while it waits for them (see stopWorkerThreads). SIGCHLD is held off with the others so only the main
+    //  thread reaps.
+    if ( numberOfWorkers > 1 ) {
+        fprintf( fp, "Serving requests with %d worker threads.\n", numberOfWorkers );
+        fflush( fp );
         
-        /* 6 - Send a message to the child to inform it that its memory request was granted. */
-        message.msg_type = message.pid;
-        if ( msgsnd( messageID, &message, sizeof( message ), 0) == -1 ) {
-            perror( "OSS: Failure to send response message to USER." );
-            return 1;
+        workers = (pthread_t *) malloc ( numberOfWorkers * sizeof ( pthread_t ) );
+        pthread_sigmask ( SIG_BLOCK, &stopSignals, &oldMask );
+        for ( i = 0; i < numberOfWorkers; ++i ) {
+            pthread_create ( &workers[i], NULL, workerThread, (void *) (long) i );
         }
-        
-    } // End of main loop
+        pthread_sigmask ( SIG_SETMASK, &oldMask, NULL );
+    }
     
-    wait ( NULL );
+    /* Main Loop */
+    // Serve requests until the last process has been created. Creating processes is an event, so it happens
+    //  in step 2 of serving a request. With worker threads they serve the requests instead, and the main thread
+    //  only starts the first process and waits.
+    if ( numberOfWorkers > 1 ) {
+        runDueEvents();
+        while ( sem_wait ( &runFinished ) == -1 ) {
+            dumpTimings();
+        }
+    } else {
+        while ( totalProcessesCreated <= maxTotalProcesses ) {
+            serveRequest();
+            dumpTimings();
+        }
+    }
+    clock_gettime( CLOCK_MONOTONIC, &endTime );
     
     cleanUpResources();
     
@@ -486,18 +710,141 @@ int main ( int argc, char *argv[] ) {
 
 /* Function Definitions */
 
-// Function that increments the clock by some amount of time at different points to simulate processing time or
-//  overhead time. Also makes sure that nanoseconds are converted to seconds if/when necessary.
-void manageClock ( unsigned int clock[] ) {
-    clock[0] += clock[1] / 1000000000;
-    clock[1] = clock[1] % 1000000000;
+// Function to serve one request from a USER: steps 2 to 5 of the main loop. Run by the main loop, or by each
+//  worker thread for the PCB slots in its shard.
+void serveRequest() {
+    int j;
+    
+    /* 2 - Run every event that is due: resume any process whose page fault I/O has finished, create a new
+     process if it is time to. Then check for a message from a child with a memory request. */
+    runDueEvents();
+    PHASE_STAMP ( phase );
+    if ( !receiveRequest() ) {
+        return;
+    }
+    PHASE_END ( PHASE_RECEIVE, phase );
+
+    /* 3 - Check for termination notice from USER. */
+    if ( message.terminate == 1 ) {
+        logEvent ( eventLog, EVENT_TERMINATED, message.pid, message.blockIndex, 0, 0, sentTime ( message.sentTime ) );
+        
+        // Clear any associated frames in the frame table based on what was stored in the PCB. This comes first,
+        //  since a process created in the slot once it is free may be forked with pages already mapped.
+        pagerRelease ( pager, message.blockIndex );
+        
+        // Reset its location PID vector
+        pthread_mutex_lock ( &ossLock );
+        pidArray[message.blockIndex] = 0;
+        activeProcesses--;
+        publishCounts();
+        pthread_mutex_unlock ( &ossLock );
+        
+        // Make sure the process terminated. reapChildren collects it. A pooled USER stays to run the next
+        //  process created in its slot.
+        if ( !poolMode ) {
+            kill( message.pid, SIGTERM );
+        }
+        
+        // If the process did terminate, none of the below code will impact it.
+        return;
+    } // End of checking for termination
+    
+    /* 4 - Resolve the memory request(s). In batch mode every reference in the batch is resolved here and its
+     hit/fault result is stored in the batch so it can go back to USER in one combined response. Any page fault
+     queues I/O on the disk, and the response waits for the last of it. */
+    faultCompletion = 0;
+    clockDebt = 0;
+    if ( batchSize > 1 ) {
+        for ( j = 0; j < batch.count; ++j ) {
+            message.pageRef = batch.refs[j].pageRef;
+            message.memoryAddress = batch.refs[j].memoryAddress;
+            message.requestType = batch.refs[j].requestType;
+            
+            batch.refs[j].result = handleMemoryRequest() ? REFERENCE_HIT : REFERENCE_FAULT;
+        }
+    } else {
+        handleMemoryRequest();
+    }
+    
+    /* 5 - Charge the time the request took, then send a message to the child to inform it that its memory request
+     was granted. If it page faulted, it waits on the disk instead and gets the message once the I/O is done (see
+     step 2 and the event queue). The clock is a single atomic counter, so a hit is charged without taking ossLock. */
+    clockAdvance ( shmClock, clockDebt );
+    if ( faultCompletion != 0 ) {
+        pthread_mutex_lock ( &ossLock );
+        parkProcess();
+        pthread_mutex_unlock ( &ossLock );
+    } else {
+        recordLatency();
+        sendResponse ( message.pid );
+    }
 }
 
  // Function to print the after-run report showing any relevant statistics.
  void printReport() {
-     totalRuntime = shmClock[0];
-     memoryAccessesPerSecond = totalMemoryRequests / totalRuntime;
-     pageFaultsPerMemoryAccess = totalPageFaults / totalMemoryRequests;
+     Pager **pagers = ( pagerGroup != NULL ) ? pagerGroup : &pager;
+     int shards = ( pagerGroup != NULL ) ? numberOfWorkers : 1;
+     long references = 0, tlbHits = 0, tlbMisses = 0, walkAccesses = 0, steals = 0, evictions = 0;
+     long prefetches = 0, prefetchHits = 0, prefetchWasted = 0;
+     long sharedMaps = 0, forks = 0, forkedPages = 0, copies = 0, mappedPages = 0, residentFrames = 0, savedFrames = 0;
+     long promotions = 0, promotedInPlace = 0, migratedPages = 0, promotionFailures = 0, demotions = 0, peakHugePages = 0, tlbReach = 0, tlbHugeHits = 0;
+     size_t tableBytes = 0, tablePeakBytes = 0;
+     double policyNanoseconds = 0;
+     double wallSeconds;
+     int i;
+     
+     // Add up the shards. A replay has already set the totals from its first pager.
+     if ( pager != NULL ) {
+         for ( i = 0; i < shards; ++i ) {
+             references += pagers[i]->references;
+             tlbHits += pagers[i]->tlbHits;
+             tlbMisses += pagers[i]->tlbMisses;
+             walkAccesses += pagers[i]->walkAccesses;
+             steals += pagers[i]->steals;
+             evictions += pagers[i]->evictions;
+             prefetches += pagers[i]->prefetches;
+             prefetchHits += pagers[i]->prefetchHits;
+             prefetchWasted += pagers[i]->prefetchWasted;
+             sharedMaps += pagers[i]->sharedMaps;
+             forks += pagers[i]->forks;
+             forkedPages += pagers[i]->forkedPages;
+             copies += pagers[i]->copies;
+             mappedPages += pagers[i]->mappedPages;
+             residentFrames += pagers[i]->residentFrames;
+             savedFrames += pagers[i]->peakSavedFrames;
+             promotions += pagers[i]->promotions;
+             promotedInPlace += pagers[i]->promotedInPlace;
+             migratedPages += pagers[i]->migratedPages;
+             promotionFailures += pagers[i]->promotionFailures;
+             demotions += pagers[i]->demotions;
+             peakHugePages += pagers[i]->peakHugeResident;
+             tlbReach += pagers[i]->tlbReach;
+             if ( pagers[i]->tlb != NULL ) {
+                 tlbHugeHits += pagers[i]->tlb->hugeHits;
+             }
+             policyNanoseconds += pagers[i]->policyNanoseconds;
+             tableBytes += pagers[i]->pageTable->bytes;
+             tablePeakBytes += pagers[i]->pageTable->peakBytes;
+             if ( pagerGroup != NULL ) {
+                 totalMemoryRequests += pagers[i]->references;
+                 totalPageFaults += pagers[i]->faults;
+             }
+         }
+     }
+     
+     totalRuntime = (double) clockNow ( shmClock ) / NANOSECONDS_PER_SECOND;
+     if ( totalRuntime > 0 ) {
+         memoryAccessesPerSecond = totalMemoryRequests / totalRuntime;
+     }
+     if ( totalMemoryRequests > 0 ) {
+         pageFaultsPerMemoryAccess = (float) totalPageFaults / totalMemoryRequests;
+     }
+     
+     // Real time spent in the main loop. This is what the two transports are compared on.
+     if ( endTime.tv_sec == 0 ) {
+         clock_gettime( CLOCK_MONOTONIC, &endTime );
+     }
+     wallSeconds = ( endTime.tv_sec - startTime.tv_sec ) + ( endTime.tv_nsec - startTime.tv_nsec ) / 1e9;
 
      printf ( "Total processes created: %d.\n", totalProcessesCreated );
      fprintf( fp, "Total processes created: %d.\n", totalProcessesCreated );
@@ -511,96 +858,1022 @@ void manageClock ( unsigned int clock[] ) {
      printf ( "Number of memory accesses per second: %f.\n", memoryAccessesPerSecond );
      fprintf( fp, "Number of memory accesses per second: %f.\n", memoryAccessesPerSecond );
      
-     printf ( "Number of page faults per second: %f.\n", pageFaultsPerMemoryAccess );
-     fprintf( fp, "Number of page faults per second: %f.\n", pageFaultsPerMemoryAccess );
+     printf ( "Number of page faults per memory access: %f.\n", pageFaultsPerMemoryAccess );
+     fprintf( fp, "Number of page faults per memory access: %f.\n", pageFaultsPerMemoryAccess );
+     
+     if ( latency.total > 0 ) {
+         printf ( "Latency per reference (simulated ns): mean %.0f, p50 %lu, p99 %lu, p99.9 %lu, max %lu.\n", histogramMean ( &latency ), histogramPercentile ( &latency, 50 ), histogramPercentile ( &latency, 99 ), histogramPercentile ( &latency, 99.9 ), latency.max );
+         fprintf( fp, "Latency per reference (simulated ns): mean %.0f, p50 %lu, p99 %lu, p99.9 %lu, max %lu.\n", histogramMean ( &latency ), histogramPercentile ( &latency, 50 ), histogramPercentile ( &latency, 99 ), histogramPercentile ( &latency, 99.9 ), latency.max );
+     }
+     
+     // Nothing was set up to report on if the run ended before the pager was created.
+     if ( pager != NULL ) {
+         printf ( "Replacement policy %s: %.4f page faults per access, %.0f ns of policy time per page fault.\n", pager->policy->name, totalMemoryRequests > 0 ? (double) totalPageFaults / totalMemoryRequests : 0.0, totalPageFaults > 0 ? policyNanoseconds / totalPageFaults : 0.0 );
+         fprintf( fp, "Replacement policy %s: %.4f page faults per access, %.0f ns of policy time per page fault.\n", pager->policy->name, totalMemoryRequests > 0 ? (double) totalPageFaults / totalMemoryRequests : 0.0, totalPageFaults > 0 ? policyNanoseconds / totalPageFaults : 0.0 );
+         
+         // TLB reach is the pages the referencing process's TLB covered, on average over the references.
+         if ( pager->tlb != NULL ) {
+             printf ( "TLB (%d entries, %d-way per process): %ld hits, %ld misses, %.4f hit rate, %.1f pages (%.0f bytes) of reach on average.\n", pager->tlb->sets * pager->tlb->ways, pager->tlb->ways, tlbHits, tlbMisses, references > 0 ? (double) tlbHits / references : 0.0, references > 0 ? (double) tlbReach / references : 0.0, references > 0 ? (double) tlbReach / references * pageSize : 0.0 );
+             fprintf( fp, "TLB (%d entries, %d-way per process): %ld hits, %ld misses, %.4f hit rate, %.1f pages (%.0f bytes) of reach on average.\n", pager->tlb->sets * pager->tlb->ways, pager->tlb->ways, tlbHits, tlbMisses, references > 0 ? (double) tlbHits / references : 0.0, references > 0 ? (double) tlbReach / references : 0.0, references > 0 ? (double) tlbReach / references * pageSize : 0.0 );
+         }
+         
+         // Huge pages at once is the most each shard had at once, added up.
+         if ( pager->hugePages > 0 ) {
+             printf ( "Huge pages (%d pages, %d bytes): %ld promoted, %ld of them in place and the rest by copying %ld pages. %ld hot regions left as they were for want of a free run of frames. %ld split up again. At most %ld at once. %lu TLB hits on huge page entries.\n", pager->hugePages, pager->hugePages * pageSize, promotions, promotedInPlace, migratedPages, promotionFailures, demotions, peakHugePages, tlbHugeHits );
+             fprintf( fp, "Huge pages (%d pages, %d bytes): %ld promoted, %ld of them in place and the rest by copying %ld pages. %ld hot regions left as they were for want of a free run of frames. %ld split up again. At most %ld at once. %lu TLB hits on huge page entries.\n", pager->hugePages, pager->hugePages * pageSize, promotions, promotedInPlace, migratedPages, promotionFailures, demotions, peakHugePages, tlbHugeHits );
+         }
+         
+         // Frames saved is the most each shard saved at once, added up.
+         if ( pager->sharedPages > 0 || forkPercent > 0 ) {
+             printf ( "Sharing (%d page shared segment, %d%% of processes forked): %ld shared pages mapped without I/O, %ld forks sharing %ld pages copy-on-write, %ld pages copied on a write. At most %ld frames saved, %ld pages mapped in %ld frames at the end.\n", pager->sharedPages, forkPercent, sharedMaps, forks, forkedPages, copies, savedFrames, mappedPages, residentFrames );
+             fprintf( fp, "Sharing (%d page shared segment, %d%% of processes forked): %ld shared pages mapped without I/O, %ld forks sharing %ld pages copy-on-write, %ld pages copied on a write. At most %ld frames saved, %ld pages mapped in %ld frames at the end.\n", pager->sharedPages, forkPercent, sharedMaps, forks, forkedPages, copies, savedFrames, mappedPages, residentFrames );
+         }
+         
+         if ( pager->prefetcher != NULL ) {
+             printf ( "Prefetcher %s (up to %d pages): %ld pages read ahead, %ld referenced (%.4f accuracy, each a page fault avoided), %ld evicted or freed unreferenced.\n", pager->prefetcher->name, pager->prefetcher->depth, prefetches, prefetchHits, prefetches > 0 ? (double) prefetchHits / prefetches : 0.0, prefetchWasted );
+             fprintf( fp, "Prefetcher %s (up to %d pages): %ld pages read ahead, %ld referenced (%.4f accuracy, each a page fault avoided), %ld evicted or freed unreferenced.\n", pager->prefetcher->name, pager->prefetcher->depth, prefetches, prefetchHits, prefetches > 0 ? (double) prefetchHits / prefetches : 0.0, prefetchWasted );
+         }
+         
+         if ( disk != NULL ) {
+             printf ( "Disk: %ld page-ins, %ld writebacks (%.4f of evictions), %.0f ns average wait per page fault, at most %d processes waiting.\n", disk->reads, evictionWritebacks, evictions > 0 ? (double) evictionWritebacks / evictions : 0.0, disk->reads > prefetchReads ? (double) disk->totalWait / ( disk->reads - prefetchReads ) : 0.0, disk->maxWaiting );
+             fprintf( fp, "Disk: %ld page-ins, %ld writebacks (%.4f of evictions), %.0f ns average wait per page fault, at most %d processes waiting.\n", disk->reads, evictionWritebacks, evictions > 0 ? (double) evictionWritebacks / evictions : 0.0, disk->reads > prefetchReads ? (double) disk->totalWait / ( disk->reads - prefetchReads ) : 0.0, disk->maxWaiting );
+             if ( cleanerBatch > 0 ) {
+                 printf ( "Page cleaner (batches of up to %d pages, above %d%% of frames dirty or %d%% with the disk idle): %ld pages written back in %ld batches, %.1f pages per batch.\n", cleanerBatch, cleanerHigh, cleanerLow, cleanedPages, cleanerBatches, cleanerBatches > 0 ? (double) cleanedPages / cleanerBatches : 0.0 );
+                 fprintf( fp, "Page cleaner (batches of up to %d pages, above %d%% of frames dirty or %d%% with the disk idle): %ld pages written back in %ld batches, %.1f pages per batch.\n", cleanerBatch, cleanerHigh, cleanerLow, cleanedPages, cleanerBatches, cleanerBatches > 0 ? (double) cleanedPages / cleanerBatches : 0.0 );
+             }
+         }
+         
+         if ( sampledProcesses > 0 ) {
+             printf ( "Working sets (%d reference window): %.1f pages per process on average, at most %ld in total for %d frames.\n", workingSetWindow, summedWorkingSets / sampledProcesses, peakWorkingSetTotal, numberOfFrames );
+             fprintf( fp, "Working sets (%d reference window): %.1f pages per process on average, at most %ld in total for %d frames.\n", workingSetWindow, summedWorkingSets / sampledProcesses, peakWorkingSetTotal, numberOfFrames );
+         }
+         if ( admissionControl ) {
+             printf ( "Admission control: %ld process creations deferred, %.3f simulated seconds spent waiting for room.\n", deferredSpawns, (double) deferredTime / NANOSECONDS_PER_SECOND );
+             fprintf( fp, "Admission control: %ld process creations deferred, %.3f simulated seconds spent waiting for room.\n", deferredSpawns, (double) deferredTime / NANOSECONDS_PER_SECOND );
+         }
+         
+         printf ( "Page table %s: %.2f entries read per page walk, %zu bytes at the end, %zu bytes at peak.\n", pager->pageTable->name, references - tlbHits > 0 ? (double) walkAccesses / ( references - tlbHits ) : 0.0, tableBytes, tablePeakBytes );
+         fprintf( fp, "Page table %s: %.2f entries read per page walk, %zu bytes at the end, %zu bytes at peak.\n", pager->pageTable->name, references - tlbHits > 0 ? (double) walkAccesses / ( references - tlbHits ) : 0.0, tableBytes, tablePeakBytes );
+         
+         if ( shards > 1 ) {
+             printf ( "Workers: %d threads, %ld frames taken from another shard.\n", shards, steals );
+             fprintf( fp, "Workers: %d threads, %ld frames taken from another shard.\n", shards, steals );
+         }
+     }
+     
+     if ( replayFile == NULL ) {
+         printf ( "Workload: %s.\n", workloadSpec );
+         fprintf( fp, "Workload: %s.\n", workloadSpec );
+     }
+     
+     if ( poolMode ) {
+         printf ( "USER pool: %d processes forked for %d simulated processes.\n", maxCurrentProcesses, totalProcessesCreated );
+         fprintf( fp, "USER pool: %d processes forked for %d simulated processes.\n", maxCurrentProcesses, totalProcessesCreated );
+     }
+     
+     if ( eventLog != NULL ) {
+         printf ( "Event log: %lu events written to %s, %lu waits for a full ring.\n", eventLog->written, eventLogName, eventLog->waits );
+         fprintf( fp, "Event log: %lu events written to %s, %lu waits for a full ring.\n", eventLog->written, eventLogName, eventLog->waits );
+     }
+     
+     printf ( "Memory requests per real second (%s): %.0f.\n", runMode(), totalMemoryRequests / wallSeconds );
+     fprintf( fp, "Memory requests per real second (%s): %.0f.\n", runMode(), totalMemoryRequests / wallSeconds );
+     
+     if ( replayFile == NULL ) {
+         phaseTimingDump ( stdout );
+         phaseTimingDump ( fp );
+     }
+     
+     if ( resultsFile != NULL ) {
+         writeResults ( wallSeconds );
+     }
  }
 
+// Function to append the run's results to resultsFile as one CSV line, with a header line first if the file is
+//  new. ./benchmark runs oss with -o and reads this back.
+void writeResults ( double wallSeconds ) {
+    FILE *out;
+    
+    if ( ( out = fopen ( resultsFile, "a" ) ) == NULL ) {
+        perror ( "OSS: Failure to open the results file." );
+        return;
+    }
+    if ( ftell ( out ) == 0 ) {
+        fprintf ( out, "workload,policy,frames,processes,workers,batch,references,faults,faultRate,wallSeconds,referencesPerSecond,simulatedSeconds,latencyMean,latencyP50,latencyP99,latencyP999\n" );
+    }
+    fprintf ( out, "%s,%s,%d,%d,%d,%d,%d,%d,%.6f,%.6f,%.1f,%.6f,%.1f,%lu,%lu,%lu\n", replayFile != NULL ? "replay" : workloadSpec, pager != NULL ? pager->policy->name : policyList, numberOfFrames, maxCurrentProcesses, numberOfWorkers, batchSize, totalMemoryRequests, totalPageFaults, totalMemoryRequests > 0 ? (double) totalPageFaults / totalMemoryRequests : 0.0, wallSeconds, totalMemoryRequests / wallSeconds, totalRuntime, histogramMean ( &latency ), histogramPercentile ( &latency, 50 ), histogramPercentile ( &latency, 99 ), histogramPercentile ( &latency, 99.9 ) );
+    fclose ( out );
+}
+
+// Function to count the latency of the request in message (or batch) as it is answered: simulated time from when
+//  USER stamped it to now, once for every reference it carried.
+void recordLatency() {
+    const unsigned int *sent = ( batchSize > 1 ) ? batch.sentTime : message.sentTime;
+    uint64_t now = clockNow ( shmClock );
+    uint64_t then = sentTime ( sent );
+    
+    histogramRecord ( &latency, now > then ? now - then : 0, ( batchSize > 1 ) ? batch.count : 1 );
+}
+
+// Function to get the name of how requests reached OSS for the report.
+const char* runMode() {
+    if ( replayFile != NULL ) {
+        return "replay";
+    }
+    return ( transport == TRANSPORT_RING ) ? "ring" : "msgqueue";
+}
+
 // Function to terminate all shared memory and message queue upon completion or to be used with signal handling.
+//  Only the first call does anything. Once it starts, the alarm is cancelled and ctrl-c and the alarm are held
+//  off, so neither can start a second clean up from sig_handle while this one is joining threads or printing.
 void cleanUpResources() {
+    sigset_t terminateSignals;
+    
+    if ( cleaningUp ) {
+        return;
+    }
+    cleaningUp = 1;
+    alarm ( 0 );
+    sigemptyset ( &terminateSignals );
+    sigaddset ( &terminateSignals, SIGINT );
+    sigaddset ( &terminateSignals, SIGALRM );
+    pthread_sigmask ( SIG_BLOCK, &terminateSignals, NULL );
+    
+    stopWorkerThreads();
+    if ( shmStats != NULL ) {
+        statsStore ( shmStats->running, 0 );
+    }
+    
+    // Write out the rest of the event log before the report reads its statistics.
+    if ( eventLog != NULL ) {
+        closeEventLog ( eventLog );
+    }
     printReport();
+    if ( eventLog != NULL ) {
+        destroyEventLog ( eventLog );
+        eventLog = NULL;
+    }
     
     // Close the file.
     fclose ( fp );
 
+    // Nothing else to clean up after a replay since no IPC was set up.
+    if ( replayFile != NULL ) {
+        return;
+    }
+    
+    // Stop the USERs while they can still be waiting on OSS, so each one writes out the rest of its trace
+    //  before the IPC it waits on goes away.
+    if ( traceFile != NULL && traceFile[0] != '\0' ) {
+        stopUsers();
+    }
+    
     // Detach from shared memory.
     shmdt ( shmClock );
 
     // Destroy shared memory.
     shmctl ( shmClockID, IPC_RMID, NULL );
+    
+    // Detach and destroy the statistics segment. An ossstat still attached keeps it until it lets go.
+    shmdt ( shmStats );
+    shmctl ( shmStatsID, IPC_RMID, NULL );
 
     // Destroy message queue.
     msgctl ( messageID, IPC_RMID, NULL );
+    
+    // Wake any USER still waiting on the ring transport, then detach and destroy it.
+    if ( transport == TRANSPORT_RING ) {
+        ringSetShutdown ( shmRing );
+        shmdt ( shmRing );
+        shmctl ( shmRingID, IPC_RMID, NULL );
+    }
+    
+    // Once no USER can append to the trace any more, add its index.
+    if ( traceFile != NULL && traceFile[0] != '\0' ) {
+        if ( !traceFinalize ( traceFile ) ) {
+            perror ( "OSS: Failure to finalize the trace file." );
+        }
+    }
 }
 
-// Function to handle signal handling. See comments above in code where this is setup to get more information.
-void sig_handle ( int sig_num ) {
-    if ( sig_num == SIGINT || sig_num == SIGALRM ) {
-        printf ( "Signal to terminate was received.\n" );
-        cleanUpResources();
-        kill ( 0, SIGKILL );
-        wait ( NULL );
-        exit ( 0 );
+// Function to resolve the memory request currently stored in message. The pager checks the process's page
+//  table for the requested page (4a) and runs the page fault/replacement logic if it is not loaded (4b). This
+//  function logs the events and charges the simulated time to clockDebt. Returns true if the page was already
+//  loaded (no page fault).
+bool handleMemoryRequest() {
+    PagerResult result;
+    unsigned long long completion;
+    int i;
+    
+    pagerReference ( pager, message.pid, message.blockIndex, message.pageRef, message.requestType == WRITE, &result );
+    PHASE_STAMP ( phase );
+    
+    // Finding the frame (or finding out there isn't one) costs a TLB hit or a page walk.
+    clockDebt += result.tlbHit ? TLB_HIT_TIME : result.walkAccesses * WALK_TIME;
+    
+    // Huge pages made at the end of the process's working set window cost a copy of each page that had to move.
+    //  One split up to evict a page costs nothing but the page table updates.
+    if ( result.promoted > 0 ) {
+        clockDebt += result.migrated * COPY_TIME;
+        logEvent ( eventLog, EVENT_PROMOTE, message.pid, message.blockIndex, result.migrated, result.promoted, clockNow ( shmClock ) );
+    }
+    if ( result.demoted ) {
+        logEvent ( eventLog, EVENT_DEMOTE, message.pid, result.evictedBlockIndex, result.frame, result.evictedPage, clockNow ( shmClock ) );
+    }
+    
+    // 4a - If the page is found in the frame table...(no page fault)...
+    if ( result.hit ) {
+        // Mapping a shared segment page costs a minor fault. Copying a page on a write costs the copy, and if a
+        //  dirty page had to be evicted for it, its writeback.
+        if ( result.sharedMap ) {
+            clockDebt += MINOR_FAULT_TIME;
+        }
+        if ( result.copied ) {
+            clockDebt += COPY_TIME;
+            logEvent ( eventLog, EVENT_COPY, message.pid, message.blockIndex, result.frame, message.pageRef, clockNow ( shmClock ) );
+            if ( result.evicted && result.evictedDirty ) {
+                pthread_mutex_lock ( &ossLock );
+                faultCompletion = diskSubmit ( disk, clockNow ( shmClock ) + clockDebt, WRITEBACK_TIME, true );
+                evictionWritebacks++;
+                publishCounts();
+                pthread_mutex_unlock ( &ossLock );
+            }
+        }
+        
+        // If memory request was a read...
+        if ( message.requestType == READ ) {
+            logEvent ( eventLog, EVENT_READ, message.pid, message.blockIndex, 0, message.memoryAddress, sentTime ( message.sentTime ) );
+            
+            // If the frame's dirty bit is not set...
+            if ( !result.dirty ) {
+                logEvent ( eventLog, EVENT_GRANTED, message.pid, message.blockIndex, result.frame, message.memoryAddress, clockNow ( shmClock ) );
+                
+                clockDebt += 10;
+            }
+            // If the frame's dirty bit is set...Takes slightly longer to read since there was something
+            //  written to the address.
+            else {
+                logEvent ( eventLog, EVENT_GRANTED_DIRTY, message.pid, message.blockIndex, result.frame, message.memoryAddress, clockNow ( shmClock ) );
+                
+                clockDebt += 15;
+            }
+        }
+        
+        // If memory request was a write...
+        if ( message.requestType == WRITE ) {
+            logEvent ( eventLog, EVENT_WRITE, message.pid, message.blockIndex, 0, message.memoryAddress, sentTime ( message.sentTime ) );
+            logEvent ( eventLog, EVENT_GRANTED, message.pid, message.blockIndex, result.frame, message.memoryAddress, clockNow ( shmClock ) );
+            
+            clockDebt += 10;
+        }
+        PHASE_END ( PHASE_LOGGING, phase );
+        
+        // A page read ahead may still be on its way in. Wait for it like a page fault.
+        if ( result.prefetchHit ) {
+            pthread_mutex_lock ( &ossLock );
+            if ( frameReady[result.frame] > clockNow ( shmClock ) + clockDebt && frameReady[result.frame] > faultCompletion ) {
+                faultCompletion = frameReady[result.frame];
+            }
+            pthread_mutex_unlock ( &ossLock );
+        }
+    } // End of 4a (no page fault)
+    
+    // 4b - if the page is not found in the frame table...(page fault/page replacement)...
+    else {
+        if ( result.evicted ) {
+            logEvent ( eventLog, EVENT_SWAP, message.pid, message.blockIndex, result.frame, message.pageRef, clockNow ( shmClock ) );
+            PHASE_END ( PHASE_LOGGING, phase );
+        }
+        
+        // Queue the I/O. A dirty page has to be written back before the new page can be read in.
+        pthread_mutex_lock ( &ossLock );
+        if ( result.evicted && result.evictedDirty ) {
+            diskSubmit ( disk, clockNow ( shmClock ) + clockDebt, WRITEBACK_TIME, true );
+            evictionWritebacks++;
+            publishCounts();
+        }
+        faultCompletion = diskSubmit ( disk, clockNow ( shmClock ) + clockDebt, FAULT_TIME, false );
+        
+        // Then the pages read ahead, each after the writeback of the page its frame held if that was dirty. One
+        //  right after the page before it (in the order they are read) only costs the transfer.
+        for ( i = 0; i < result.prefetched; ++i ) {
+            if ( result.prefetchDirty & ( 1u << i ) ) {
+                diskSubmit ( disk, clockNow ( shmClock ) + clockDebt, WRITEBACK_TIME, true );
+                evictionWritebacks++;
+            }
+            completion = diskSubmit ( disk, clockNow ( shmClock ) + clockDebt, !( result.prefetchDirty & ( 1u << i ) ) && result.prefetchPages[i] == ( i > 0 ? result.prefetchPages[i - 1] : message.pageRef ) + 1 ? READAHEAD_TIME : FAULT_TIME, false );
+            frameReady[result.prefetchFrames[i]] = completion;
+            prefetchReads++;
+            logEvent ( eventLog, EVENT_PREFETCH, message.pid, message.blockIndex, result.prefetchFrames[i], result.prefetchPages[i], completion );
+        }
+        if ( result.prefetchDirty != 0 ) {
+            publishCounts();
+        }
+        pthread_mutex_unlock ( &ossLock );
+    } // End of 4b (page replacement)
+    
+    return result.hit;
+}
+
+// Function to get the time a USER stamped on its request in nanoseconds.
+uint64_t sentTime ( const unsigned int time[] ) {
+    return time[0] * NANOSECONDS_PER_SECOND + time[1];
+}
+
+// Function to run every event on the queue that is due by the simulated clock. If no process can run (none are
+//  active, or every one is waiting on the disk) nothing else moves the clock, so it jumps to the next event. A
+//  resumed process's response is sent after ossLock is let go. Any thread can run any event.
+void runDueEvents() {
+    ScheduledEvent event;
+    uint64_t next;
+    sigset_t oldMask;
+    long sendTo;
+    bool due;
+    
+    do {
+        pthread_sigmask ( SIG_BLOCK, &stopSignals, &oldMask );
+        pthread_mutex_lock ( &ossLock );
+        if ( activeProcesses == disk->count && nextEventTime ( events, &next ) ) {
+            clockAdvanceTo ( shmClock, next );
+        }
+        
+        sendTo = 0;
+        if ( ( due = takeDueEvent ( events, clockNow ( shmClock ), &event ) ) ) {
+            switch ( event.type ) {
+                case SPAWN_EVENT:
+                    if ( spawnProcess() ) {
+                        sendTo = poolPids[message.blockIndex];
+                    }
+                    break;
+                case DISK_DONE_EVENT:
+                    resumeProcess ( event.blockIndex );
+                    sendTo = message.pid;
+                    break;
+                case SAMPLE_EVENT:
+                    sampleStatistics();
+                    break;
+                case CLEAN_EVENT:
+                    runCleaner();
+                    break;
+            }
+        }
+        pthread_mutex_unlock ( &ossLock );
+        pthread_sigmask ( SIG_SETMASK, &oldMask, NULL );
+        
+        if ( sendTo != 0 ) {
+            sendResponse ( sendTo );
+        }
+    } while ( due );
+}
+
+// Function to create a new process if there is room in the PCB, and schedule the next one 1-5ms of simulated
+//  time later. Stops once the last process has been created. With the USER pool nothing is forked: the process
+//  gets a logical PID, and its start message is left in message for the caller to send to the slot's USER.
+//  Returns true if there is a start message to send. Called holding ossLock.
+bool spawnProcess() {
+    bool started = false;
+    int i;
+    
+    if ( totalProcessesCreated > maxTotalProcesses ) {
+        return false;
+    }
+    
+    // OSS needs to find an available location in the PCB by checking the pidArray.
+    for ( i = 0; i < maxCurrentProcesses; ++i ) {
+        if ( pidArray[i] == 0 ) {
+            break;
+        }
+    }
+    
+    // If the process doesn't fit in memory, it waits for the next spawn time as if the PCB were full.
+    if ( i < maxCurrentProcesses && !admitProcess ( i ) ) {
+        if ( deferredSince == 0 ) {
+            deferredSince = clockNow ( shmClock );
+            deferredSpawns++;
+            publishCounts();
+        }
+        i = maxCurrentProcesses;
+    } else if ( i < maxCurrentProcesses && deferredSince != 0 ) {
+        deferredTime += clockNow ( shmClock ) - deferredSince;
+        deferredSince = 0;
+    }
+    
+    // If there was room, fork the process (or start the pooled one).
+    if ( i < maxCurrentProcesses ) {
+        if ( poolMode ) {
+            pid = nextPoolPid++;
+            memset ( &message, 0, sizeof ( message ) );
+            memset ( &batch, 0, offsetof ( BatchMessage, refs ) );
+            message.pid = batch.pid = pid;
+            message.blockIndex = batch.blockIndex = i;
+            started = true;
+        } else if ( ( pid = forkUser ( i, totalProcessesCreated ) ) == -1 ) {
+            perror( "OSS: Failure to fork the child process." );
+            kill( getpid(), SIGINT );
+        }
+        
+        if ( pid != -1 ) {
+            pidArray[i] = pid;
+            activeProcesses++;
+            logEvent ( eventLog, EVENT_CREATED, pid, i, 0, 0, clockNow ( shmClock ) );
+            if ( forkPercent > 0 && rand() % 100 < forkPercent ) {
+                forkProcess ( i );
+            }
+            
+            totalProcessesCreated++;
+            publishCounts();
+        }
+    }
+    
+    // Set a new time for the next process to be created after, or let the main thread know it is done.
+    if ( totalProcessesCreated <= maxTotalProcesses ) {
+        scheduleEvent ( events, clockNow ( shmClock ) + ( rand() % ( 5000000 - 1000000 + 1 ) + 1000000 ), SPAWN_EVENT, -1 );
+    } else {
+        sem_post ( &runFinished );
+    }
+    
+    return started;
+}
+
+// Function to make the process just created in PCB slot blockIndex a fork of a running process in the same shard,
+//  picked at random. It starts out with the parent's loaded pages shared copy-on-write. Called holding ossLock.
+void forkProcess ( int blockIndex ) {
+    int start = rand() % maxCurrentProcesses;
+    int i, parent, pages;
+    
+    for ( i = 0; i < maxCurrentProcesses; ++i ) {
+        parent = ( start + i ) % maxCurrentProcesses;
+        if ( parent != blockIndex && pidArray[parent] != 0 && parent % numberOfWorkers == blockIndex % numberOfWorkers ) {
+            pages = pagerFork ( pagerGroup[blockIndex % numberOfWorkers], parent, blockIndex );
+            logEvent ( eventLog, EVENT_FORK, pidArray[blockIndex], blockIndex, parent, pages, clockNow ( shmClock ) );
+            return;
+        }
+    }
+}
+
+// Function to fork and exec a USER for PCB slot blockIndex. processNumber seeds its workload (a pooled USER uses
+//  the logical PID of each process instead). Returns its PID, or -1 if the fork failed.
+pid_t forkUser ( int blockIndex, int processNumber ) {
+    pid_t child = fork();
+    
+    // In the child process...
+    if ( child == 0 ) {
+        // Create a buffer for the child's index to in the PCB to pass with execl. The thread that forked it
+        //  may have had signals blocked, so USER starts with none blocked.
+        char indexBuffer[12];
+        char numberBuffer[12];
+        sigset_t none;
+        sigemptyset ( &none );
+        sigprocmask ( SIG_SETMASK, &none, NULL );
+        sprintf( indexBuffer, "%d", blockIndex );
+        sprintf( numberBuffer, "%d", processNumber );
+        execl( "./user", "user", indexBuffer, transportBuffer, batchBuffer, traceFile, pageSizeBuffer, pagesBuffer, workersBuffer, poolBuffer, workloadSpec, numberBuffer, NULL );
+        _exit( 1 );
+    }
+    
+    return child;
+}
+
+// Function to reap every USER that has exited. Run on SIGCHLD so no thread ever blocks waiting for one.
+void reapChildren ( int sig_num ) {
+    int savedErrno = errno;
+    
+    while ( waitpid ( -1, NULL, WNOHANG ) > 0 ) {
+    }
+    errno = savedErrno;
+}
+
+// Function to log how many processes are active and waiting on the disk, once every simulated second while
+//  processes are still being created. Called holding ossLock.
+void sampleStatistics() {
+    uint64_t now = clockNow ( shmClock );
+    
+    logEvent ( eventLog, EVENT_SAMPLE, 0, totalProcessesCreated, disk->count, activeProcesses, now );
+    if ( totalProcessesCreated <= maxTotalProcesses ) {
+        scheduleEvent ( events, now + SAMPLE_INTERVAL, SAMPLE_EVENT, -1 );
+    }
+}
+
+// Function to run the page cleaner. If enough frames are dirty for the state the disk is in, one batch from the
+//  shard with the most dirty frames is queued on the disk. Its pages are clean in the frame table from now on,
+//  but any page fault queued after it waits for it. The cleaner wakes up again once the batch is done, when the
+//  disk is next idle, or after CLEAN_INTERVAL if there was nothing to do. Called holding ossLock.
+void runCleaner() {
+    uint64_t now = clockNow ( shmClock );
+    uint64_t next = now + CLEAN_INTERVAL;
+    long dirty = 0, most = -1;
+    int i, shard = 0, blockIndex, count;
+    
+    for ( i = 0; i < numberOfWorkers; ++i ) {
+        dirty += statsLoad ( pagerGroup[i]->dirtyFrames );
+        if ( statsLoad ( pagerGroup[i]->dirtyFrames ) > most ) {
+            most = statsLoad ( pagerGroup[i]->dirtyFrames );
+            shard = i;
+        }
+    }
+    
+    if ( ( dirty * 100 > (long) cleanerHigh * numberOfFrames || ( disk->busyUntil <= now && dirty * 100 > (long) cleanerLow * numberOfFrames ) )
+         && ( count = pagerClean ( pagerGroup[shard], cleanerBatch, &blockIndex, cleanerPages ) ) > 0 ) {
+        next = diskSubmit ( disk, now, WRITEBACK_TIME + ( count - 1 ) * (unsigned long long) WRITEBACK_BATCH_TIME, true );
+        cleanedPages += count;
+        cleanerBatches++;
+        publishCounts();
+        
+        logEvent ( eventLog, EVENT_CLEAN, pidArray[blockIndex], blockIndex, cleanerPages[0], count, next );
+    } else if ( disk->busyUntil > now ) {
+        next = disk->busyUntil;
+    }
+    
+    if ( totalProcessesCreated <= maxTotalProcesses ) {
+        scheduleEvent ( events, next, CLEAN_EVENT, -1 );
+    }
+}
+
+// Function to park the process that sent the current request until its I/O is done. Its response is saved,
+//  and its wake-up is scheduled on the event queue. Called holding ossLock.
+void parkProcess() {
+    if ( batchSize > 1 ) {
+        memcpy ( parkedResponses + message.blockIndex * parkedResponseSize, &batch, parkedResponseSize );
+    } else {
+        memcpy ( parkedResponses + message.blockIndex * parkedResponseSize, &message, parkedResponseSize );
+    }
+    diskPark ( disk, clockNow ( shmClock ), faultCompletion );
+    scheduleEvent ( events, faultCompletion, DISK_DONE_EVENT, message.blockIndex );
+    publishCounts();
+    
+    logEvent ( eventLog, EVENT_DISK_WAIT, message.pid, message.blockIndex, 0, 0, faultCompletion );
+}
+
+// Function to publish the counts kept under ossLock to the statistics segment. Called holding ossLock.
+void publishCounts() {
+    statsStore ( shmStats->activeProcesses, activeProcesses );
+    statsStore ( shmStats->processesCreated, totalProcessesCreated );
+    statsStore ( shmStats->diskWaiting, disk->count );
+    statsStore ( shmStats->writebacks, evictionWritebacks );
+    statsStore ( shmStats->cleanedPages, cleanedPages );
+    statsStore ( shmStats->deferredSpawns, deferredSpawns );
+}
+
+// Function to decide if a new process in PCB slot blockIndex fits in memory. The working sets of the active
+//  processes are added up for the report either way. With admission control, they plus an estimate of the new
+//  one's, their mean, have to fit in the frame table. The first process's estimate is pagesPerProcess. Called
+//  holding ossLock.
+bool admitProcess ( int blockIndex ) {
+    long total = workingSetTotal();
+    int estimate = ( activeProcesses > 0 ) ? ( total + activeProcesses - 1 ) / activeProcesses : pagesPerProcess;
+    
+    if ( total > peakWorkingSetTotal ) {
+        peakWorkingSetTotal = total;
+    }
+    summedWorkingSets += total;
+    sampledProcesses += activeProcesses;
+    statsStore ( shmStats->workingSetTotal, total );
+    
+    if ( admissionControl && activeProcesses > 0 && total + estimate > numberOfFrames ) {
+        return false;
+    }
+    
+    admittedEstimate[blockIndex] = estimate;
+    return true;
+}
+
+// Function to add up the working sets of the active processes. One whose first window hasn't ended yet counts
+//  the estimate it was admitted with. Called holding ossLock.
+long workingSetTotal() {
+    long total = 0;
+    int i, pages;
+    
+    for ( i = 0; i < maxCurrentProcesses; ++i ) {
+        if ( pidArray[i] != 0 ) {
+            pages = statsLoad ( pager->workingSets[i] );
+            total += ( pages > 0 ) ? pages : admittedEstimate[i];
+        }
+    }
+    
+    return total;
+}
+
+// Function to restore the saved response of a parked process whose I/O is done, so the caller can send it.
+//  Called holding ossLock.
+void resumeProcess ( int blockIndex ) {
+    if ( batchSize > 1 ) {
+        memcpy ( &batch, parkedResponses + blockIndex * parkedResponseSize, parkedResponseSize );
+        message.pid = batch.pid;
+        message.blockIndex = batch.blockIndex;
+    } else {
+        memcpy ( &message, parkedResponses + blockIndex * parkedResponseSize, parkedResponseSize );
+    }
+    diskResume ( disk );
+    publishCounts();
+    recordLatency();
+    
+    logEvent ( eventLog, EVENT_DISK_DONE, message.pid, blockIndex, 0, 0, clockNow ( shmClock ) );
+}
+
+// Function to create the shared memory, message queue and (if selected) ring transport used to talk to
+//  USER processes. Returns 1 on failure.
+int setupIPC() {
+    /* Shared Memory */
+    // Create shared memory block for simulated system clock.
+    if ( ( shmClockID = shmget ( shmKey, sizeof ( SimClock ), IPC_CREAT | 0666 ) ) == -1 ) {
+        perror ( "OSS: Failure to create shared memory space for simulated clock." );
+        return 1;
     }
+    
+    // Attach to and initialize shared memory.
+    if ( ( shmClock = (SimClock *) shmat ( shmClockID, NULL, 0 ) ) == (void *) -1 ) {
+        perror ( "OSS: Failure to attach to shared memory space for simulated clock." );
+        return 1;
+    }
+    clockSet ( shmClock, 1 );   // The simulated clock starts at 0:1.
+    
+    // Create the live statistics segment and describe the run in it. The pagers publish their counters to it.
+    if ( ( shmStatsID = shmget ( shmStatsKey, statsSegmentSize ( maxCurrentProcesses ), IPC_CREAT | 0666 ) ) == -1 ) {
+        perror ( "OSS: Failure to create shared memory space for statistics." );
+        return 1;
+    }
+    if ( ( shmStats = (StatsSegment *) shmat ( shmStatsID, NULL, 0 ) ) == (void *) -1 ) {
+        perror ( "OSS: Failure to attach to shared memory space for statistics." );
+        return 1;
+    }
+    memset ( shmStats, 0, statsSegmentSize ( maxCurrentProcesses ) );
+    shmStats->ossPid = getpid();
+    shmStats->slots = maxCurrentProcesses;
+    shmStats->frames = numberOfFrames;
+    shmStats->shardCount = numberOfWorkers;
+    shmStats->pagesPerProcess = pagesPerProcess;
+    shmStats->maxProcesses = maxTotalProcesses + 1;
+    shmStats->workingSetWindow = workingSetWindow;
+    shmStats->admissionControl = admissionControl;
+    shmStats->cleanerBatch = cleanerBatch;
+    snprintf ( shmStats->policy, sizeof ( shmStats->policy ), "%s", policyList );
+    snprintf ( shmStats->workload, sizeof ( shmStats->workload ), "%s", workloadSpec );
+    snprintf ( shmStats->mode, sizeof ( shmStats->mode ), "%s", runMode() );
+    shmStats->workers = numberOfWorkers;
+    shmStats->batchSize = batchSize;
+    shmStats->poolMode = poolMode;
+    shmStats->version = STATS_VERSION;
+    __atomic_store_n ( &shmStats->magic, STATS_MAGIC, __ATOMIC_RELEASE );
+    
+
+    /* Message Queue */
+    // Create the message queue used for IPC.
+    if ( ( messageID = msgget ( messageKey, IPC_CREAT | 0666 ) ) == -1 ) {
+        perror ( "OSS: Failure to create the message queue." );
+        return 1;
+    }
+    
+    // Create and attach the ring transport segment if it was selected. One request and one response ring
+    //  are made for each slot in the PCB.
+    if ( transport == TRANSPORT_RING ) {
+        if ( ( shmRingID = shmget ( shmRingKey, ringSetSize ( maxCurrentProcesses ), IPC_CREAT | 0666 ) ) == -1 ) {
+            perror ( "OSS: Failure to create shared memory space for ring transport." );
+            return 1;
+        }
+        
+        if ( ( shmRing = (RingSet *) shmat ( shmRingID, NULL, 0 ) ) == (void *) -1 ) {
+            perror ( "OSS: Failure to attach to shared memory space for ring transport." );
+            return 1;
+        }
+        ringSetInit ( shmRing, maxCurrentProcesses, numberOfWorkers );
+    }
+    
+    return 0;
 }
 
-// Function to create a queue of given capacity.
-// It initializes size of queue as 0.
-Queue* createQueue ( unsigned capacity ) {
-    Queue* queue = (Queue*) malloc ( sizeof ( Queue ) );
-    queue->capacity = capacity;
-    queue->front = queue->size = 0;
-    queue->rear = capacity - 1;    // This is important, see the enqueue
-    queue->array = (int*) malloc ( queue->capacity * sizeof ( int ) );
+// Replay job. Each policy being simulated gets its own pager and thread, all reading the same mapping.
+typedef struct {
+    pthread_t thread;
+    const TraceMap* trace;
+    Pager* pager;
+    double seconds;             // Real time the thread took.
+} ReplayJob;
+
+// Function to replay a trace file straight into the frame table and PCB, with one pager per policy in -p.
+//  Every record goes through the same pager logic as the main loop, but there are no USER processes,
+//  messages or alarm, so the same trace always gives the same page faults. The trace is mapped, not read,
+//  so a large trace starts right away and the threads share its pages in the page cache.
+int replayTrace() {
+    TraceMap trace;
+    ReplayJob jobs[16];
+    char *name, *save;
+    int numberOfJobs = 0;
+    int i;
+    
+    if ( !traceMap ( &trace, replayFile ) ) {
+        fprintf ( stderr, "OSS: Failure to map trace file %s for replay.\n", replayFile );
+        return 1;
+    }
+    useTraceGeometry ( &trace );
     
-    return queue;
+    for ( name = strtok_r ( policyList, ",", &save ); name != NULL && numberOfJobs < 16; name = strtok_r ( NULL, ",", &save ) ) {
+        jobs[numberOfJobs].trace = &trace;
+        if ( ( jobs[numberOfJobs].pager = createPager ( pagerConfig ( name ) ) ) == NULL ) {
+            fprintf ( stderr, "OSS: Unknown page replacement policy %s or page table %s. Choose from: %s and %s.\n", name, pageTableName, policyNames(), pageTableNames() );
+            return 1;
+        }
+        numberOfJobs++;
+    }
+    
+    fprintf( fp, "Replaying trace %s: %lu records from %u processes.\n", replayFile, (unsigned long) trace.recordCount, trace.processCount );
+    clock_gettime( CLOCK_MONOTONIC, &startTime );
+    
+    for ( i = 0; i < numberOfJobs; ++i ) {
+        pthread_create ( &jobs[i].thread, NULL, replayThread, &jobs[i] );
+    }
+    for ( i = 0; i < numberOfJobs; ++i ) {
+        pthread_join ( jobs[i].thread, NULL );
+    }
+    
+    clock_gettime( CLOCK_MONOTONIC, &endTime );
+    
+    // The first policy goes in the regular report. The simulated time is the time the trace ends at.
+    pager = jobs[0].pager;
+    totalMemoryRequests = pager->references;
+    totalPageFaults = pager->faults;
+    if ( trace.recordCount > 0 ) {
+        clockSet ( shmClock, sentTime ( trace.records[trace.recordCount - 1].sentTime ) );
+    }
+    
+    // One line per policy so they can be compared.
+    for ( i = 0; i < numberOfJobs; ++i ) {
+        printf ( "Replay %s: %ld references, %ld page faults (%.4f per access), %.0f references per real second.\n", jobs[i].pager->policy->name, jobs[i].pager->references, jobs[i].pager->faults, jobs[i].pager->references > 0 ? (double) jobs[i].pager->faults / jobs[i].pager->references : 0.0, jobs[i].pager->references / jobs[i].seconds );
+        fprintf( fp, "Replay %s: %ld references, %ld page faults (%.4f per access), %.0f references per real second.\n", jobs[i].pager->policy->name, jobs[i].pager->references, jobs[i].pager->faults, jobs[i].pager->references > 0 ? (double) jobs[i].pager->faults / jobs[i].pager->references : 0.0, jobs[i].pager->references / jobs[i].seconds );
+        if ( jobs[i].pager->prefetcher != NULL ) {
+            printf ( "Replay %s with prefetcher %s: %ld pages read ahead, %ld referenced (%.4f accuracy).\n", jobs[i].pager->policy->name, jobs[i].pager->prefetcher->name, jobs[i].pager->prefetches, jobs[i].pager->prefetchHits, jobs[i].pager->prefetches > 0 ? (double) jobs[i].pager->prefetchHits / jobs[i].pager->prefetches : 0.0 );
+            fprintf( fp, "Replay %s with prefetcher %s: %ld pages read ahead, %ld referenced (%.4f accuracy).\n", jobs[i].pager->policy->name, jobs[i].pager->prefetcher->name, jobs[i].pager->prefetches, jobs[i].pager->prefetchHits, jobs[i].pager->prefetches > 0 ? (double) jobs[i].pager->prefetchHits / jobs[i].pager->prefetches : 0.0 );
+        }
+    }
+    
+    cleanUpResources();
+    traceUnmap ( &trace );
+    for ( i = 0; i < numberOfJobs; ++i ) {
+        destroyPager ( jobs[i].pager );
+    }
+    
+    return 0;
 }
 
-// Queue is full when size becomes equal to the capacity
-int isFull ( Queue* queue ) {
-    return ( queue->size == queue->capacity );
+// Function to get the pager settings from the command line, with the given replacement policy.
+const PagerConfig* pagerConfig ( const char* policy ) {
+    static PagerConfig config;
+    
+    config.frames = numberOfFrames;
+    config.processes = maxCurrentProcesses;
+    config.pagesPerProcess = pagesPerProcess;
+    config.policy = policy;
+    config.pageTable = pageTableName;
+    config.tlbEntries = tlbEntries;
+    config.tlbWays = tlbWays;
+    config.workingSetWindow = workingSetWindow;
+    config.prefetch = prefetchSpec;
+    config.sharedPages = sharedPages;
+    config.copyOnWrite = forkPercent > 0;
+    config.hugePages = hugePages;
+    config.stats = shmStats;
+    
+    return &config;
+}
+
+// Function to size the PCB for a replay from the trace header. The trace records how many PCB slots and
+//  pages per process the run that recorded it had; traces from before that was recorded used the defaults.
+void useTraceGeometry ( const TraceMap* trace ) {
+    maxCurrentProcesses = trace->header->processSlots > 0 ? (int) trace->header->processSlots : DEFAULT_PROCESSES;
+    pagesPerProcess = trace->header->pagesPerProcess > 0 ? (int) trace->header->pagesPerProcess : DEFAULT_PAGES_PER_PROCESS;
+}
+
+// Function to simulate every frame table size in -S with every policy in -p over the trace, and print the
+//  fault rate table. See sweep.c.
+int sweepTrace() {
+    TraceMap trace;
+    Sweep sweep;
+    char *item, *save;
+    
+    memset ( &sweep, 0, sizeof ( sweep ) );
+    for ( item = strtok_r ( sweepList, ",", &save ); item != NULL && sweep.sizeCount < MAX_SWEEP_SIZES; item = strtok_r ( NULL, ",", &save ) ) {
+        if ( ( sweep.sizes[sweep.sizeCount] = atoi ( item ) ) < 1 ) {
+            fprintf ( stderr, "OSS: Frame table size %s is not valid.\n", item );
+            return 1;
+        }
+        sweep.sizeCount++;
+    }
+    for ( item = strtok_r ( policyList, ",", &save ); item != NULL && sweep.policyCount < MAX_SWEEP_POLICIES; item = strtok_r ( NULL, ",", &save ) ) {
+        sweep.policies[sweep.policyCount++] = item;
+    }
+    if ( sweep.sizeCount == 0 ) {
+        fprintf ( stderr, "OSS: No frame table sizes given to -S.\n" );
+        return 1;
+    }
+    
+    if ( !traceMap ( &trace, replayFile ) ) {
+        fprintf ( stderr, "OSS: Failure to map trace file %s for replay.\n", replayFile );
+        return 1;
+    }
+    useTraceGeometry ( &trace );
+    sweep.config = *pagerConfig ( policyList );
+    sweep.config.prefetch = NULL;   // Read-ahead, sharing and huge pages (whose promotions move pages to other frames)
+    sweep.config.sharedPages = 0;   //  would throw off the stack distance column, which has none of them.
+    sweep.config.hugePages = 0;
+    
+    if ( !runSweep ( &sweep, &trace ) ) {
+        fprintf ( stderr, "OSS: Unknown page replacement policy or page table %s. Choose from: %s and %s.\n", pageTableName, policyNames(), pageTableNames() );
+        traceUnmap ( &trace );
+        return 1;
+    }
+    
+    fprintf( fp, "Sweeping trace %s: %lu records from %u processes.\n", replayFile, (unsigned long) trace.recordCount, trace.processCount );
+    printSweep ( &sweep, stdout );
+    printSweep ( &sweep, fp );
+    
+    fclose ( fp );
+    traceUnmap ( &trace );
+    
+    return 0;
 }
 
-// Queue is empty when size is 0
-int isEmpty ( Queue* queue ) {
-    return ( queue->size == 0 );
+// Function run by each replay thread. Walks every record in the mapped trace.
+void* replayThread ( void* arg ) {
+    ReplayJob* job = (ReplayJob*) arg;
+    const TraceRecord* record = job->trace->records;
+    const TraceRecord* end = record + job->trace->recordCount;
+    struct timespec start, finish;
+    PagerResult result;
+    
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    
+    for ( ; record < end; ++record ) {
+        if ( record->flags & TRACE_TERMINATE ) {
+            pagerRelease ( job->pager, record->blockIndex );
+        } else {
+            pagerReference ( job->pager, record->pid, record->blockIndex, record->pageRef, ( record->flags & TRACE_WRITE ) != 0, &result );
+        }
+    }
+    
+    clock_gettime( CLOCK_MONOTONIC, &finish );
+    job->seconds = ( finish.tv_sec - start.tv_sec ) + ( finish.tv_nsec - start.tv_nsec ) / 1e9;
+    
+    return NULL;
 }
 
-// Function to add an item to the queue.
-// It changes rear and size.
-void enqueue ( Queue* queue, int item ) {
-    if ( isFull ( queue ) )
+// Function to stop any USER still running and wait for it, so nothing is still appending to the trace
+//  when it gets indexed. USER writes out its buffered records when it gets SIGTERM (see user.c), so every
+//  USER is sent one before any is waited for.
+void stopUsers() {
+    pid_t *pids = ( poolPids != NULL ) ? poolPids : pidArray;
+    int i;
+    
+    if ( pidArray == NULL ) {
         return;
+    }
+    
+    for ( i = 0; i < maxCurrentProcesses; ++i ) {
+        if ( pids[i] > 0 ) {
+            kill ( pids[i], SIGTERM );
+        }
+    }
     
-    queue->rear = ( queue->rear + 1 ) % queue->capacity;
-    queue->array[queue->rear] = item;
-    queue->size = queue->size + 1;
+    for ( i = 0; i < maxCurrentProcesses; ++i ) {
+        if ( pids[i] > 0 ) {
+            waitpid ( pids[i], NULL, 0 );
+            pids[i] = 0;
+        }
+        pidArray[i] = 0;
+    }
 }
 
-// Function to remove an item from queue.
-// It changes front and size.
-int dequeue ( Queue* queue ) {
-    if ( isEmpty ( queue ) )
-        return INT_MIN;
+// Function to receive the next memory request from any USER over the selected transport.
+//  In batch mode the batch header is copied into message so the rest of the main loop can
+//  treat it like a single request. With worker threads, USER sends requests as message type
+//  shard + 1 so each worker only receives its own shard's. Returns false if nothing was
+//  received (the worker was woken up to stop).
+bool receiveRequest() {
+    void *buffer = &message;
+    size_t size = sizeof ( message );
     
-    int item = queue->array[queue->front];
-    queue->front = ( queue->front + 1 ) % queue->capacity;
-    queue->size = queue->size - 1;
+    if ( batchSize > 1 ) {
+        buffer = &batch;
+        size = batchMessageSize ( batchSize );
+    }
     
-    return item;
+    if ( transport == TRANSPORT_RING ) {
+        if ( ringReceiveRequest ( shmRing, workerShard, buffer, size ) == -1 ) {
+            return false;
+        }
+    } else if ( msgrcv( messageID, buffer, size - sizeof( long ), numberOfWorkers > 1 ? workerShard + 1 : getpid(), 0 ) == -1 ) {
+        return false;
+    }
+    if ( __atomic_load_n ( &stopWorkers, __ATOMIC_SEQ_CST ) ) {
+        return false;
+    }
+    
+    if ( batchSize > 1 ) {
+        message.pid = batch.pid;
+        message.blockIndex = batch.blockIndex;
+        message.terminate = batch.terminate;
+        message.sentTime[0] = batch.sentTime[0];
+        message.sentTime[1] = batch.sentTime[1];
+    }
+    return true;
 }
 
-// Function to get front of queue.
-int front ( Queue* queue ) {
-    if ( isEmpty ( queue ) )
-        return INT_MIN;
+// Function run by each worker thread (oss -w). Serves the requests of one shard of the PCB with its own pager
+//  until OSS is done creating processes.
+void* workerThread ( void* arg ) {
+    workerShard = (int) (long) arg;
+    pager = pagerGroup[workerShard];
+    
+    while ( !__atomic_load_n ( &stopWorkers, __ATOMIC_SEQ_CST ) ) {
+        serveRequest();
+    }
     
-    return queue->array[queue->front];
+    return NULL;
 }
 
-// Function to get rear of queue.
-int rear ( Queue* queue ) {
-    if ( isEmpty ( queue ) )
-        return INT_MIN;
+// Function to stop the worker threads and wait for them. A worker asleep in receiveRequest is woken up with
+//  an empty message of its type, or by closing its shard of the ring transport.
+void stopWorkerThreads() {
+    Message wake;
+    int i;
     
-    return queue->array[queue->rear];
+    if ( workers == NULL ) {
+        return;
+    }
+    
+    __atomic_store_n ( &stopWorkers, true, __ATOMIC_SEQ_CST );
+    memset ( &wake, 0, sizeof ( wake ) );
+    for ( i = 0; i < numberOfWorkers; ++i ) {
+        if ( transport == TRANSPORT_RING ) {
+            ringCloseShard ( shmRing, i );
+        } else {
+            wake.msg_type = i + 1;
+            msgsnd( messageID, &wake, sizeof( wake ) - sizeof( long ), 0 );
+        }
+    }
+    
+    for ( i = 0; i < numberOfWorkers; ++i ) {
+        pthread_join ( workers[i], NULL );
+    }
+    free ( workers );
+    workers = NULL;
+}
+
+// Function to send the current message (or batch) to the USER in its PCB slot: a response goes to the PID that
+//  sent the request, a pooled USER's start message to its real PID. A send interrupted by SIGCHLD is retried.
+void sendResponse ( long type ) {
+    void *buffer = &message;
+    size_t size = sizeof ( message );
+    PHASE_STAMP ( phase );
+    
+    message.msg_type = type;
+    if ( batchSize > 1 ) {
+        batch.msg_type = type;
+        buffer = &batch;
+        size = batchMessageSize ( batchSize );
+    }
+    
+    if ( transport == TRANSPORT_RING ) {
+        ringSendResponse ( shmRing, message.blockIndex, buffer, size );
+        PHASE_END ( PHASE_SEND, phase );
+        return;
+    }
+    while ( msgsnd( messageID, buffer, size - sizeof( long ), 0) == -1 ) {
+        if ( errno != EINTR ) {
+            perror( "OSS: Failure to send response message to USER." );
+            cleanUpResources();
+            exit( 1 );
+        }
+    }
+    PHASE_END ( PHASE_SEND, phase );
+}
+
+// Function to note a SIGUSR1. The dump itself is printed by the main thread (see dumpTimings).
+void requestDump ( int sig_num ) {
+    dumpRequested = 1;
+}
+
+// Function to print the latency and phase timing so far to stderr if SIGUSR1 asked for it. Called by the main
+//  thread between requests, or when a SIGUSR1 interrupts its wait for the workers.
+void dumpTimings() {
+    if ( !dumpRequested ) {
+        return;
+    }
+    dumpRequested = 0;
+    
+    fprintf ( stderr, "Latency per reference (simulated ns): %lu references, mean %.0f, p50 %lu, p99 %lu, p99.9 %lu, max %lu.\n", latency.total, histogramMean ( &latency ), histogramPercentile ( &latency, 50 ), histogramPercentile ( &latency, 99 ), histogramPercentile ( &latency, 99.9 ), latency.max );
+    phaseTimingDump ( stderr );
+}
+
+// Function to handle signal handling. See comments above in code where this is setup to get more information.
+//  A signal that gets in after the clean up has started leaves it to finish.
+void sig_handle ( int sig_num ) {
+    if ( cleaningUp ) {
+        return;
+    }
+    if ( sig_num == SIGINT || sig_num == SIGALRM ) {
+        printf ( "Signal to terminate was received.\n" );
+        cleanUpResources();
+        kill ( 0, SIGKILL );
+        wait ( NULL );
+        exit ( 0 );
+    }
 }
@@ -0,0 +1,193 @@
+// File name: ossstat.c
+// Executable: ossstat
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Program to watch a running OSS. Attaches the live statistics segment (see stats.h) and the
+//  simulated clock read-only and prints their counters every interval, top style, until OSS
+//  finishes. Nothing it does touches OSS, so it can be started and stopped at any time.
+
+#include "header.h"
+
+
+/* Structures */
+// Totals over the pager shards at one refresh.
+typedef struct {
+    unsigned long references;
+    unsigned long faults;
+    unsigned long evictions;
+    long freeFrames;
+    long residentFrames;
+    long dirtyFrames;
+} Totals;
+
+
+/* Variables */
+StatsSegment *stats;
+int *residentPages;             // Copy of the resident pages per PCB slot, so they hold still while sorted.
+int *workingSets;
+int *slotOrder;                 // PCB slots sorted by resident pages, for the table.
+
+
+/* Function Prototypes */
+void addShards ( Totals* totals );
+int byResidentPages ( const void* a, const void* b );
+void printStats ( const Totals* now, const Totals* before, double interval, int top );
+
+
+int main ( int argc, char *argv[] ) {
+    SimClock *clock = NULL;
+    Totals now, before;
+    double interval = 1.0;
+    int count = -1, top = 10, batchMode = 0;
+    int statsID, clockID, opt;
+    struct shmid_ds info;
+    struct timespec pause;
+
+    while ( ( opt = getopt ( argc, argv, "bhi:n:t:" ) ) != -1 ) {
+        switch ( opt ) {
+            case 'b':
+                batchMode = 1;
+                break;
+            case 'i':
+                interval = atof ( optarg );
+                if ( interval < 0.05 ) {
+                    interval = 0.05;
+                }
+                break;
+            case 'n':
+                count = atoi ( optarg );
+                break;
+            case 't':
+                top = atoi ( optarg );
+                break;
+            default:
+                printf ( "Program: ./ossstat (while oss is running)\n" );
+                printf ( "Options:\n" );
+                printf ( "\t-i : seconds between refreshes (default 1)\n" );
+                printf ( "\t-n : number of refreshes (default until oss finishes)\n" );
+                printf ( "\t-t : PCB slots listed, most resident pages first (default 10)\n" );
+                printf ( "\t-b : print one refresh after another instead of redrawing the screen\n" );
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    // Attach read-only. The clock is only for display, so ossstat runs without it.
+    if ( ( statsID = shmget ( shmStatsKey, 0, 0 ) ) == -1 || ( stats = (StatsSegment *) shmat ( statsID, NULL, SHM_RDONLY ) ) == (void *) -1 ) {
+        fprintf ( stderr, "OSSSTAT: No oss is running (no statistics segment).\n" );
+        return 1;
+    }
+    if ( __atomic_load_n ( &stats->magic, __ATOMIC_ACQUIRE ) != STATS_MAGIC || stats->version != STATS_VERSION ) {
+        fprintf ( stderr, "OSSSTAT: The statistics segment is from another version of oss.\n" );
+        shmdt ( stats );
+        return 1;
+    }
+    if ( ( clockID = shmget ( shmKey, 0, 0 ) ) != -1 && ( clock = (SimClock *) shmat ( clockID, NULL, SHM_RDONLY ) ) == (void *) -1 ) {
+        clock = NULL;
+    }
+
+    residentPages = (int *) malloc ( stats->slots * sizeof ( int ) );
+    workingSets = (int *) malloc ( stats->slots * sizeof ( int ) );
+    slotOrder = (int *) malloc ( stats->slots * sizeof ( int ) );
+    pause.tv_sec = (time_t) interval;
+    pause.tv_nsec = (long) ( ( interval - pause.tv_sec ) * 1e9 );
+
+    addShards ( &before );
+    while ( count != 0 ) {
+        nanosleep ( &pause, NULL );
+        addShards ( &now );
+
+        if ( !batchMode ) {
+            printf ( "\033[H\033[2J" );
+        }
+        if ( clock != NULL ) {
+            printf ( "Simulated time %u:%09u\n", clockSeconds ( clockNow ( clock ) ), clockNanoseconds ( clockNow ( clock ) ) );
+        }
+        printStats ( &now, &before, interval, top );
+        fflush ( stdout );
+        before = now;
+
+        // Stop once OSS is done with the segment or has gone away without removing it.
+        if ( shmctl ( statsID, IPC_STAT, &info ) == -1 || ( info.shm_perm.mode & SHM_DEST ) || ( kill ( stats->ossPid, 0 ) == -1 && errno == ESRCH ) ) {
+            printf ( "oss has finished.\n" );
+            break;
+        }
+        if ( count > 0 ) {
+            count--;
+        }
+    }
+
+    free ( residentPages );
+    free ( workingSets );
+    free ( slotOrder );
+    if ( clock != NULL ) {
+        shmdt ( clock );
+    }
+    shmdt ( stats );
+    return 0;
+}
+
+
+/* Function Definitions */
+
+// Function to add up the counters of every pager shard.
+void addShards ( Totals* totals ) {
+    int i;
+
+    memset ( totals, 0, sizeof ( Totals ) );
+    for ( i = 0; i < stats->shardCount && i < STATS_MAX_SHARDS; ++i ) {
+        totals->references += statsLoad ( stats->shards[i].references );
+        totals->faults += statsLoad ( stats->shards[i].faults );
+        totals->evictions += statsLoad ( stats->shards[i].evictions );
+        totals->freeFrames += statsLoad ( stats->shards[i].freeFrames );
+        totals->residentFrames += statsLoad ( stats->shards[i].residentFrames );
+        totals->dirtyFrames += statsLoad ( stats->shards[i].dirtyFrames );
+    }
+}
+
+// Function to order PCB slots by resident pages, most first.
+int byResidentPages ( const void* a, const void* b ) {
+    int left = residentPages[*(const int *) a];
+    int right = residentPages[*(const int *) b];
+
+    return ( left < right ) - ( left > right );
+}
+
+// Function to print one refresh: the run, its counters with their rates since the last refresh, and the PCB
+//  slots with the most pages loaded.
+void printStats ( const Totals* now, const Totals* before, double interval, int top ) {
+    unsigned long references = now->references - before->references;
+    unsigned long faults = now->faults - before->faults;
+    int i, loaded = 0;
+
+    printf ( "oss %d: %s, -w %d, -b %d%s, policy %s, workload %s. %s.\n", (int) stats->ossPid, stats->mode, stats->workers, stats->batchSize, stats->poolMode ? ", -F" : "", stats->policy, stats->workload, statsLoad ( stats->running ) ? "Running" : "Not serving requests" );
+    printf ( "Processes: %ld active, %ld of %d created, %ld waiting on the disk.\n", statsLoad ( stats->activeProcesses ), statsLoad ( stats->processesCreated ), stats->maxProcesses, statsLoad ( stats->diskWaiting ) );
+    printf ( "Frames: %d, %ld free, %ld resident, %ld dirty.\n", stats->frames, now->freeFrames, now->residentFrames, now->dirtyFrames );
+    printf ( "References: %lu total, %.0f/s. Hits: %lu, %.4f of references in the last interval.\n", now->references, references / interval, now->references - now->faults, references > 0 ? (double) ( references - faults ) / references : 0.0 );
+    printf ( "Faults: %lu total, %.0f/s. Evictions: %lu. Dirty writebacks: %lu.", now->faults, faults / interval, now->evictions, statsLoad ( stats->writebacks ) );
+    if ( stats->cleanerBatch > 0 ) {
+        printf ( " Cleaned ahead: %lu.", statsLoad ( stats->cleanedPages ) );
+    }
+    printf ( "\n" );
+
+    for ( i = 0; i < stats->slots; ++i ) {
+        residentPages[i] = statsLoad ( statsResidentPages ( stats )[i] );
+        workingSets[i] = statsLoad ( statsWorkingSets ( stats )[i] );
+        slotOrder[i] = i;
+    }
+    qsort ( slotOrder, stats->slots, sizeof ( int ), byResidentPages );
+
+    printf ( "Working sets (%d reference window): %ld pages in total for %d frames.", stats->workingSetWindow, statsLoad ( stats->workingSetTotal ), stats->frames );
+    if ( stats->admissionControl ) {
+        printf ( " Process creations deferred: %ld.", statsLoad ( stats->deferredSpawns ) );
+    }
+    printf ( "\n\n%6s %10s %12s\n", "Slot", "Resident", "Working set" );
+    for ( i = 0; i < stats->slots && i < top; ++i ) {
+        if ( residentPages[slotOrder[i]] == 0 ) {
+            break;
+        }
+        printf ( "%6d %10d %12d\n", slotOrder[i], residentPages[slotOrder[i]], workingSets[slotOrder[i]] );
+        loaded++;
+    }
+    printf ( "(%d of %d slots shown, of %d pages each)\n\n", loaded, stats->slots, stats->pagesPerProcess );
+}
@@ -0,0 +1,1053 @@
+// File name: pager.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Paging logic shared by the OSS main loop and trace replay. See pager.h.
+
+#include "pager.h"
+#include "phasetime.h"
+
+#include <stdlib.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+
+/* Frame table helpers */
+
+// Tables at least this big are mapped so the kernel can back them with huge pages.
+#define HUGE_TABLE_BYTES ( 2 * 1024 * 1024 )
+
+// Function to allocate one of the pager's tables. Big ones get their own mapping with transparent
+//  huge pages asked for, since a frame table for millions of frames is walked all over by the policies.
+static void* allocateTable ( size_t bytes ) {
+    void* table;
+
+    if ( bytes < HUGE_TABLE_BYTES ) {
+        return malloc ( bytes );
+    }
+
+    if ( ( table = mmap ( NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) ) == MAP_FAILED ) {
+        return NULL;
+    }
+    madvise ( table, bytes, MADV_HUGEPAGE );
+
+    return table;
+}
+
+static void freeTable ( void* table, size_t bytes ) {
+    if ( bytes < HUGE_TABLE_BYTES ) {
+        free ( table );
+    } else if ( table != NULL ) {
+        munmap ( table, bytes );
+    }
+}
+
+// Function to add change to the number of the pager's frames that are dirty. OSS reads it from other threads to
+//  decide when to clean.
+static void countDirty ( Pager* pager, int change ) {
+    statsStore ( pager->dirtyFrames, statsLoad ( pager->dirtyFrames ) + change );
+}
+
+// Function to tell if the pager numbers its policy's slots by frame (see Pager).
+static bool framesAreSlots ( Pager* pager ) {
+    return pager->slotCount == pager->frames;
+}
+
+// Function to give a frame the shard just loaded a page into a slot, and tell the replacement policy about it.
+static void policyInsert ( Pager* pager, int frame, unsigned long key ) {
+    int slot = frame;
+
+    if ( !framesAreSlots ( pager ) ) {
+        slot = pager->freeSlots[--pager->freeSlotCount];
+        pager->slotFrames[slot] = frame;
+        pager->frameSlots[frame] = slot;
+    }
+    pager->policy->onInsert ( pager->policy, slot, key );
+}
+
+static void policyHit ( Pager* pager, int frame ) {
+    pager->policy->onHit ( pager->policy, framesAreSlots ( pager ) ? frame : pager->frameSlots[frame] );
+}
+
+// Function to take a frame the shard no longer holds out of the replacement policy and give up its slot.
+static void policyFree ( Pager* pager, int frame ) {
+    if ( framesAreSlots ( pager ) ) {
+        pager->policy->onFree ( pager->policy, frame );
+        return;
+    }
+    pager->policy->onFree ( pager->policy, pager->frameSlots[frame] );
+    pager->freeSlots[pager->freeSlotCount++] = pager->frameSlots[frame];
+}
+
+// Function to have the replacement policy pick a victim. Its slot is given up. Returns its frame.
+static int policyVictim ( Pager* pager, unsigned long key ) {
+    int slot = pager->policy->selectVictim ( pager->policy, key );
+
+    if ( framesAreSlots ( pager ) ) {
+        return slot;
+    }
+    pager->freeSlots[pager->freeSlotCount++] = slot;
+    return pager->slotFrames[slot];
+}
+
+// Function to find the shard that owns a frame: the frame table is cut into runs of 2^hugeOrder frames, and
+//  each shard owns a range of them (see shardRange).
+static Pager* frameOwner ( Pager* pager, int frame ) {
+    long runs = ( pager->frames + ( 1 << pager->hugeOrder ) - 1 ) >> pager->hugeOrder;
+
+    if ( pager->group == NULL ) {
+        return pager;
+    }
+    return pager->group[( frame >> pager->hugeOrder ) * (long) pager->shards / runs];
+}
+
+// Function to reset a frame and give it back to the buddy allocator of the shard that owns it, under its
+//  freeLock.
+static void freeFrame ( Pager* pager, int frame ) {
+    Pager* owner = frameOwner ( pager, frame );
+
+    pager->referencedFrames[frame] = 0;
+    pager->prefetchedFrames[frame] = 0;
+    pager->reverseMaps[frame] = -1;
+    pager->mapCounts[frame] = 0;
+    pager->frameTable[frame].occupiedBit = 0;
+    pager->frameTable[frame].dirtyBit = 0;
+    pager->frameTable[frame].blockIndex = 0;
+    pager->frameTable[frame].processPage = 0;
+
+    if ( owner->group != NULL ) {
+        pthread_mutex_lock ( &owner->freeLock );
+    }
+    buddyFree ( owner->buddy, frame, 0 );
+    if ( owner->stats != NULL ) {
+        statsStore ( owner->stats->freeFrames, owner->buddy->freeFrames );
+    }
+    if ( owner->group != NULL ) {
+        pthread_mutex_unlock ( &owner->freeLock );
+    }
+}
+
+// Function to take a free run of 2^order of the pager's own frames from its buddy allocator. Other shards in
+//  its group take them too, so it is done under its freeLock. Returns the first frame, -1 if there is no
+//  run that big.
+static int allocateFrames ( Pager* pager, int order ) {
+    int frame;
+
+    if ( pager->group != NULL ) {
+        pthread_mutex_lock ( &pager->freeLock );
+    }
+    frame = buddyAllocate ( pager->buddy, order );
+    if ( pager->stats != NULL ) {
+        statsStore ( pager->stats->freeFrames, pager->buddy->freeFrames );
+    }
+    if ( pager->group != NULL ) {
+        pthread_mutex_unlock ( &pager->freeLock );
+    }
+    return frame;
+}
+
+// Function to add change to the number of pages a PCB slot has loaded. Only the pager that owns the slot's pages
+//  changes it, under its lock, so a load and a store are enough to keep it right for readers of the segment.
+static void countResident ( Pager* pager, int blockIndex, int change ) {
+    statsStore ( pager->residentPages[blockIndex], statsLoad ( pager->residentPages[blockIndex] ) + change );
+}
+
+// Function to tell if page of the PCB slot local is part of a huge page.
+static bool isHuge ( Pager* pager, int local, int page ) {
+    return pager->hugePages > 0 && ( page >> pager->hugeOrder ) < pager->regions
+           && pager->hugeRegions[(long) local * pager->regions + ( page >> pager->hugeOrder )];
+}
+
+// Function to map page of the PCB slot local to frame in its page table, and add the entry to the frame's
+//  reverse map and the slot's resident list. A page of a huge page is left to the huge page's table entry.
+static void addMapping ( Pager* pager, int frame, int local, int page ) {
+    int entry = pager->freeMapping;
+    Mapping* mapping = &pager->mappings[entry];
+
+    pager->freeMapping = mapping->next;
+    mapping->local = local;
+    mapping->page = page;
+    mapping->frame = frame;
+    mapping->previous = -1;
+    mapping->next = pager->reverseMaps[frame];
+    if ( mapping->next != -1 ) {
+        pager->mappings[mapping->next].previous = entry;
+    }
+    pager->reverseMaps[frame] = entry;
+    mapping->processPrevious = -1;
+    mapping->processNext = pager->residentLists[local];
+    if ( mapping->processNext != -1 ) {
+        pager->mappings[mapping->processNext].processPrevious = entry;
+    }
+    pager->residentLists[local] = entry;
+    pager->mapCounts[frame]++;
+    pager->mappedPages++;
+
+    if ( !isHuge ( pager, local, page ) ) {
+        pager->pageTable->map ( pager->pageTable, local, page, frame );
+    }
+    countResident ( pager, local * pager->shards + pager->shard, 1 );
+}
+
+// Function to find the entry of the PCB slot local on a frame's reverse map. A process maps a frame at most once,
+//  and a frame is mapped by one process unless it is shared, so the walk is short.
+static int findMapping ( Pager* pager, int frame, int local ) {
+    int entry = pager->reverseMaps[frame];
+
+    while ( pager->mappings[entry].local != local ) {
+        entry = pager->mappings[entry].next;
+    }
+    return entry;
+}
+
+// Function to unmap a page table entry: out of the page table, off its frame's reverse map and its slot's resident
+//  list, and back on the free list. If the slot was the one the frame table names and others still map the frame,
+//  one of them is named instead. The TLB is left to the caller, and so is the table entry of a huge page.
+static void removeMapping ( Pager* pager, int entry ) {
+    Mapping* mapping = &pager->mappings[entry];
+    Frame* owner = &pager->frameTable[mapping->frame];
+
+    if ( !isHuge ( pager, mapping->local, mapping->page ) ) {
+        pager->pageTable->unmap ( pager->pageTable, mapping->local, mapping->page );
+    }
+    if ( mapping->previous != -1 ) {
+        pager->mappings[mapping->previous].next = mapping->next;
+    } else {
+        pager->reverseMaps[mapping->frame] = mapping->next;
+    }
+    if ( mapping->next != -1 ) {
+        pager->mappings[mapping->next].previous = mapping->previous;
+    }
+    if ( mapping->processPrevious != -1 ) {
+        pager->mappings[mapping->processPrevious].processNext = mapping->processNext;
+    } else {
+        pager->residentLists[mapping->local] = mapping->processNext;
+    }
+    if ( mapping->processNext != -1 ) {
+        pager->mappings[mapping->processNext].processPrevious = mapping->processPrevious;
+    }
+    mapping->next = pager->freeMapping;
+    pager->freeMapping = entry;
+    pager->mapCounts[mapping->frame]--;
+    pager->mappedPages--;
+    countResident ( pager, mapping->local * pager->shards + pager->shard, -1 );
+
+    if ( pager->reverseMaps[mapping->frame] != -1 && owner->blockIndex == mapping->local * pager->shards + pager->shard ) {
+        owner->blockIndex = pager->mappings[pager->reverseMaps[mapping->frame]].local * pager->shards + pager->shard;
+        owner->processPage = pager->mappings[pager->reverseMaps[mapping->frame]].page;
+    }
+}
+
+// Function to note the most frames sharing has saved so far.
+static void countSaved ( Pager* pager ) {
+    if ( pager->mappedPages - pager->residentFrames > pager->peakSavedFrames ) {
+        pager->peakSavedFrames = pager->mappedPages - pager->residentFrames;
+    }
+}
+
+// Function to split the huge page holding page of the PCB slot local, in frame, back into base pages. They stay
+//  in the frames they are in.
+static void demoteRegion ( Pager* pager, int local, int page, int frame ) {
+    int first = page & ~( pager->hugePages - 1 );
+    int i;
+
+    frame -= page - first;
+    pager->pageTable->unmapHuge ( pager->pageTable, local, first );
+    pager->hugeRegions[(long) local * pager->regions + ( page >> pager->hugeOrder )] = 0;
+    for ( i = 0; i < pager->hugePages; ++i ) {
+        pager->pageTable->map ( pager->pageTable, local, first + i, frame + i );
+    }
+    if ( pager->tlb != NULL ) {
+        tlbInvalidate ( pager->tlb, local, first );
+    }
+    pager->hugeCounts[local]--;
+    pager->hugeResident--;
+    pager->demotions++;
+}
+
+// Function to make a region of the PCB slot local, with every page loaded in a frame of its own, a huge page.
+//  If its pages are already in an aligned run of frames in order, only the page table changes. Otherwise they
+//  are copied into a free run from the buddy allocator, and if there is none the region is left as it is, so
+//  promoting never evicts anything. page is the one being referenced, whose frame in result is kept right.
+static void promoteRegion ( Pager* pager, long pid, int local, int region, int page, PagerResult* result ) {
+    int first = region << pager->hugeOrder;
+    int i, run, frame, accesses;
+    bool inPlace;
+
+    run = pager->pageTable->lookup ( pager->pageTable, local, first, &accesses );
+    inPlace = ( run & ( pager->hugePages - 1 ) ) == 0;
+    for ( i = 1; i < pager->hugePages && inPlace; ++i ) {
+        inPlace = pager->pageTable->lookup ( pager->pageTable, local, first + i, &accesses ) == run + i;
+    }
+    if ( !inPlace && ( run = allocateFrames ( pager, pager->hugeOrder ) ) == -1 ) {
+        pager->promotionFailures++;
+        return;
+    }
+
+    // Take the pages out of the page table and TLB. A page that moves takes its frame's state with it, and the
+    //  frame it leaves goes back to the buddy allocator.
+    for ( i = 0; i < pager->hugePages; ++i ) {
+        if ( pager->tlb != NULL ) {
+            tlbInvalidate ( pager->tlb, local, first + i );
+        }
+        if ( inPlace ) {
+            pager->pageTable->unmap ( pager->pageTable, local, first + i );
+            continue;
+        }
+        frame = pager->pageTable->lookup ( pager->pageTable, local, first + i, &accesses );
+        pager->frameTable[run + i] = pager->frameTable[frame];
+        removeMapping ( pager, findMapping ( pager, frame, local ) );
+        policyFree ( pager, frame );
+        freeFrame ( pager, frame );
+    }
+
+    pager->hugeRegions[(long) local * pager->regions + region] = 1;
+    if ( inPlace ) {
+        pager->promotedInPlace++;
+    } else {
+        for ( i = 0; i < pager->hugePages; ++i ) {
+            addMapping ( pager, run + i, local, first + i );
+            policyInsert ( pager, run + i, pageKey ( pid, first + i ) );
+        }
+        pager->migratedPages += pager->hugePages;
+        result->migrated += pager->hugePages;
+    }
+    pager->pageTable->mapHuge ( pager->pageTable, local, first, run );
+
+    if ( ( page >> pager->hugeOrder ) == region ) {
+        result->frame = run + ( page - first );
+    }
+    pager->hugeCounts[local]++;
+    if ( ++pager->hugeResident > pager->peakHugeResident ) {
+        pager->peakHugeResident = pager->hugeResident;
+    }
+    pager->promotions++;
+    result->promoted++;
+}
+
+// Function to count a reference toward its PCB slot's working set window, and end the window if that was the
+//  last reference in it: the slot's working set becomes the pages it referenced in the window (capped at its
+//  address space), and their reference bytes are cleared for the next one. With huge pages, each region whose
+//  pages were all referenced in the window, each in a frame of its own, is hot and fully populated, and is
+//  promoted to a huge page. page and result are the reference's, for promoteRegion.
+static void countWindowReference ( Pager* pager, long pid, int blockIndex, int local, int page, PagerResult* result ) {
+    int entry, frame, region, pages, hot = 0;
+
+    if ( pager->workingSetWindow <= 0 || ++pager->windowReferences[blockIndex] < pager->workingSetWindow ) {
+        return;
+    }
+
+    pages = pager->windowPages[blockIndex];
+    for ( entry = pager->residentLists[local]; entry != -1; entry = pager->mappings[entry].processNext ) {
+        frame = pager->mappings[entry].frame;
+        if ( !pager->referencedFrames[frame] ) {
+            continue;
+        }
+        pager->referencedFrames[frame] = 0;
+        pages++;
+
+        region = pager->mappings[entry].page >> pager->hugeOrder;
+        if ( pager->hugePages > 0 && region < pager->regions && pager->mapCounts[frame] == 1
+             && ++pager->regionPages[region] == pager->hugePages ) {
+            pager->hotRegions[hot++] = region;
+        }
+    }
+
+    statsStore ( pager->workingSets[blockIndex], pages < pager->pagesPerProcess ? pages : pager->pagesPerProcess );
+    pager->windowPages[blockIndex] = 0;
+    pager->windowReferences[blockIndex] = 0;
+
+    if ( pager->hugePages == 0 ) {
+        return;
+    }
+    for ( entry = pager->residentLists[local]; entry != -1; entry = pager->mappings[entry].processNext ) {
+        if ( ( region = pager->mappings[entry].page >> pager->hugeOrder ) < pager->regions ) {
+            pager->regionPages[region] = 0;
+        }
+    }
+    while ( hot > 0 ) {
+        region = pager->hotRegions[--hot];
+        if ( ( region << pager->hugeOrder ) >= pager->sharedPages && !pager->hugeRegions[(long) local * pager->regions + region] ) {
+            promoteRegion ( pager, pid, local, region, page, result );
+        }
+    }
+}
+
+// Function to publish the pager's counters to the statistics segment, if there is one.
+static void publishStats ( Pager* pager ) {
+    if ( pager->stats == NULL ) {
+        return;
+    }
+
+    statsStore ( pager->stats->references, pager->references );
+    statsStore ( pager->stats->faults, pager->faults );
+    statsStore ( pager->stats->evictions, pager->evictions );
+    statsStore ( pager->stats->residentFrames, pager->residentFrames );
+    statsStore ( pager->stats->dirtyFrames, pager->dirtyFrames );
+}
+
+// Function to have the replacement policy pick one of the pager's frames and unload its page. The page
+//  table (and TLB) of the process whose page it was is updated. Returns the frame.
+static int evictFrame ( Pager* pager, unsigned long key, PagerResult* result ) {
+    int victim = policyVictim ( pager, key );
+    Frame* frame = &pager->frameTable[victim];
+    Mapping* mapping;
+
+    result->evicted = true;
+    result->evictedBlockIndex = frame->blockIndex;
+    result->evictedPage = frame->processPage;
+    result->evictedDirty = frame->dirtyBit;
+    if ( frame->dirtyBit ) {
+        countDirty ( pager, -1 );
+    }
+    if ( frame->processPage < pager->sharedPages ) {
+        pager->sharedFrames[frame->processPage] = -1;
+    }
+
+    // A frame of a huge page (never shared) is split off it first. The rest of the pages stay as base pages.
+    mapping = &pager->mappings[pager->reverseMaps[victim]];
+    if ( isHuge ( pager, mapping->local, mapping->page ) ) {
+        demoteRegion ( pager, mapping->local, mapping->page, victim );
+        result->demoted = true;
+    }
+
+    // Unmap it from every process that has it.
+    while ( pager->reverseMaps[victim] != -1 ) {
+        mapping = &pager->mappings[pager->reverseMaps[victim]];
+        if ( pager->tlb != NULL ) {
+            tlbInvalidate ( pager->tlb, mapping->local, mapping->page );
+        }
+        removeMapping ( pager, pager->reverseMaps[victim] );
+    }
+    pager->evictions++;
+    pager->residentFrames--;
+
+    // A page referenced in this window still counts toward its process's working set once it is gone.
+    if ( pager->referencedFrames[victim] ) {
+        pager->referencedFrames[victim] = 0;
+        pager->windowPages[frame->blockIndex]++;
+    }
+    if ( pager->prefetchedFrames[victim] ) {
+        pager->prefetchedFrames[victim] = 0;
+        pager->prefetchWasted++;
+    }
+
+    return victim;
+}
+
+// Function to take a frame from another shard in the group. A free frame is taken if there is one, which
+//  only needs that shard's freeLock, and if evict is set a shard with none free gives up one of its pages
+//  instead. That needs its lock, so only a caller that holds no lock of its own evicts (see takeFrame).
+//  Returns -1 if no frame was taken.
+static int stealFrame ( Pager* pager, unsigned long key, PagerResult* result, bool evict ) {
+    Pager* other;
+    int i, frame = -1;
+
+    for ( i = 1; i < pager->shards && frame == -1; ++i ) {
+        other = pager->group[( pager->shard + i ) % pager->shards];
+        if ( ( frame = allocateFrames ( other, 0 ) ) != -1 || !evict ) {
+            continue;
+        }
+        pthread_mutex_lock ( &other->lock );
+        if ( other->residentFrames > 0 ) {
+            frame = evictFrame ( other, key, result );
+        }
+        publishStats ( other );
+        pthread_mutex_unlock ( &other->lock );
+    }
+    return frame;
+}
+
+// Function to find a frame for a page without waiting: a free one, a free one taken from another shard, or one
+//  the replacement policy gives up. A shard with every slot in use only replaces its own pages. Returns -1 if
+//  the shard holds no frames and none could be taken.
+static int findFrame ( Pager* pager, unsigned long key, PagerResult* result ) {
+    int frame = -1;
+
+    if ( pager->residentFrames < pager->slotCount && ( frame = allocateFrames ( pager, 0 ) ) == -1 && pager->group != NULL
+         && ( frame = stealFrame ( pager, key, result, false ) ) != -1 ) {
+        pager->steals++;
+    }
+    if ( frame == -1 && pager->residentFrames > 0 ) {
+        frame = evictFrame ( pager, key, result );
+    }
+    return frame;
+}
+
+// Function to get a frame for a page (see findFrame). A shard that holds no frames while the others are busy
+//  lets go of its lock and waits for theirs to evict one of their pages, so shards that have run dry never
+//  keep each other out. It holds nothing another shard could take in the meantime.
+static int takeFrame ( Pager* pager, unsigned long key, PagerResult* result ) {
+    int frame;
+
+    while ( ( frame = findFrame ( pager, key, result ) ) == -1 ) {
+        pthread_mutex_unlock ( &pager->lock );
+        frame = stealFrame ( pager, key, result, true );
+        pthread_mutex_lock ( &pager->lock );
+        if ( frame != -1 ) {
+            pager->steals++;
+            break;
+        }
+        sched_yield();
+    }
+    return frame;
+}
+
+// Function to give a process its own copy of a copy-on-write page it is writing to. Its entry comes off the
+//  shared frame, which stays with the processes still mapping it, and the page goes into a frame of its own,
+//  found the same as on a page fault. The copy is made in memory, so it is dirty and nothing is read.
+static void copyOnWrite ( Pager* pager, long pid, int local, int page, PagerResult* result ) {
+    unsigned long key = pageKey ( pid, page );
+    Frame* frame;
+
+    removeMapping ( pager, findMapping ( pager, result->frame, local ) );
+    if ( pager->tlb != NULL ) {
+        tlbInvalidate ( pager->tlb, local, page );
+    }
+
+    result->frame = takeFrame ( pager, key, result );
+    frame = &pager->frameTable[result->frame];
+    frame->occupiedBit = 1;
+    frame->dirtyBit = 1;
+    frame->blockIndex = local * pager->shards + pager->shard;
+    frame->processPage = page;
+    countDirty ( pager, 1 );
+    addMapping ( pager, result->frame, local, page );
+    if ( pager->tlb != NULL ) {
+        tlbInsert ( pager->tlb, local, page, result->frame );
+    }
+    policyInsert ( pager, result->frame, key );
+    pager->residentFrames++;
+    pager->referencedFrames[result->frame] = 1;
+    pager->copies++;
+    result->copied = true;
+}
+
+// Function to read ahead the pages the prefetcher predicts the process wants after faulting on page. Each one
+//  that isn't loaded yet goes into a free frame, one taken from another shard, or one the replacement policy
+//  gives up, the same as a page fault, but stays out of the TLB and the working set until it is referenced.
+//  Called before the faulting page gets its frame, so making room for these can't evict it. What was read
+//  goes in result for OSS to queue on the disk.
+static void prefetchPages ( Pager* pager, long pid, int blockIndex, int local, int page, PagerResult* result ) {
+    int pages[MAX_PREFETCH];
+    PagerResult victim;
+    unsigned long key;
+    int count, i, frame, accesses;
+    Frame* entry;
+
+    count = pager->prefetcher->predict ( pager->prefetcher, local, page, pages );
+    for ( i = 0; i < count; ++i ) {
+        if ( pages[i] == page || pager->pageTable->lookup ( pager->pageTable, local, pages[i], &accesses ) != -1
+             || ( pages[i] < pager->sharedPages && pager->sharedFrames[pages[i]] != -1 ) ) {
+            continue;
+        }
+
+        key = pageKey ( pid, pages[i] );
+        victim.evicted = false;
+        if ( ( frame = findFrame ( pager, key, &victim ) ) == -1 ) {
+            break;
+        }
+
+        entry = &pager->frameTable[frame];
+        entry->occupiedBit = 1;
+        entry->dirtyBit = 0;
+        entry->blockIndex = blockIndex;
+        entry->processPage = pages[i];
+        addMapping ( pager, frame, local, pages[i] );
+        if ( pages[i] < pager->sharedPages ) {
+            pager->sharedFrames[pages[i]] = frame;
+        }
+        policyInsert ( pager, frame, key );
+        pager->residentFrames++;
+        pager->prefetchedFrames[frame] = 1;
+
+        if ( victim.evicted && victim.evictedDirty ) {
+            result->prefetchDirty |= 1u << result->prefetched;
+        }
+        result->prefetchPages[result->prefetched] = pages[i];
+        result->prefetchFrames[result->prefetched++] = frame;
+        pager->prefetches++;
+    }
+}
+
+
+/* Function Definitions */
+
+// Function to create a pager. Returns NULL if there is no replacement policy or page table backend by
+//  the names given or the tables can't be allocated.
+Pager* createPager ( const PagerConfig* config ) {
+    Pager* pager;
+
+    return createPagerGroup ( config, 1, &pager ) ? pager : NULL;
+}
+
+// Function to find the range of frames a shard owns: the frame table is cut into runs of 2^order frames, and
+//  each shard gets an even share of them in one piece, so its range starts on a multiple of 2^order and a
+//  huge page's run never crosses into another shard's. Sets count to the frames in it and returns the first.
+static int shardRange ( int frames, int shards, int shard, int order, int* count ) {
+    long runs = ( frames + ( 1 << order ) - 1 ) >> order;
+    long first = ( ( shard * runs + shards - 1 ) / shards ) << order;
+    long last = ( ( ( shard + 1 ) * runs + shards - 1 ) / shards ) << order;
+
+    if ( last > frames ) {
+        last = frames;
+    }
+    *count = first < last ? last - first : 0;
+    return first < last ? first : frames;
+}
+
+// Function to create a group of pagers, one per shard, sharing one frame table. group must have room for
+//  shards pagers and stay around as long as they do, since they steal frames from each other through it.
+//  Returns false (and creates nothing) under the same conditions as createPager.
+bool createPagerGroup ( const PagerConfig* config, int shards, Pager** group ) {
+    int processes = ( config->processes + shards - 1 ) / shards;
+    Frame* frameTable = (Frame*) allocateTable ( config->frames * sizeof ( Frame ) );
+    Pager* pager;
+    int i, j, order, first, share;
+
+    for ( order = 0; ( 1 << order ) < config->hugePages; ++order ) {
+    }
+    for ( i = 0; i < shards; ++i ) {
+        pager = group[i] = (Pager*) calloc ( 1, sizeof ( Pager ) );
+        pager->frames = config->frames;
+        pager->processes = processes;
+        pager->slots = config->processes;
+        pager->pagesPerProcess = config->pagesPerProcess;
+        pager->frameTable = frameTable;
+        pager->shard = i;
+        pager->shards = shards;
+        pager->group = ( shards > 1 ) ? group : NULL;
+        pthread_mutex_init ( &pager->lock, NULL );
+        pthread_mutex_init ( &pager->freeLock, NULL );
+        first = shardRange ( config->frames, shards, i, order, &share );
+        pager->slotCount = share + ( config->frames + shards - 1 ) / shards;
+        if ( pager->slotCount > config->frames ) {
+            pager->slotCount = config->frames;
+        }
+        pager->slotFrames = (int*) malloc ( pager->slotCount * sizeof ( int ) );
+        pager->freeSlots = (int*) malloc ( pager->slotCount * sizeof ( int ) );
+        for ( j = pager->slotCount - 1; pager->freeSlots != NULL && j >= 0; --j ) {
+            pager->freeSlots[pager->freeSlotCount++] = j;
+        }
+        pager->policy = createPolicy ( config->policy, pager->slotCount, share );
+        pager->hugePages = config->hugePages;
+        pager->hugeOrder = order;
+        pager->regions = pager->hugePages > 0 ? config->pagesPerProcess / pager->hugePages : 0;
+        pager->hugeRegions = (unsigned char*) calloc ( (size_t) processes * pager->regions + 1, 1 );
+        pager->hugeCounts = (int*) calloc ( processes, sizeof ( int ) );
+        pager->regionPages = (int*) calloc ( pager->regions + 1, sizeof ( int ) );
+        pager->hotRegions = (int*) malloc ( ( pager->regions + 1 ) * sizeof ( int ) );
+        pager->pageTable = createPageTable ( config->pageTable, processes, config->pagesPerProcess, pager->slotCount, config->hugePages );
+        pager->tlb = createTlb ( processes, config->tlbEntries, config->tlbWays, config->hugePages );
+        pager->prefetcher = prefetcherWanted ( config->prefetch ) ? createPrefetcher ( config->prefetch, processes, config->pagesPerProcess ) : NULL;
+        pager->buddy = createBuddy ( first, share, pager->hugeOrder );
+        pager->sharedPages = config->sharedPages < config->pagesPerProcess ? config->sharedPages : config->pagesPerProcess;
+        pager->sharedFrames = (int*) malloc ( ( pager->sharedPages > 0 ? pager->sharedPages : 1 ) * sizeof ( int ) );
+        for ( j = 0; j < pager->sharedPages; ++j ) {
+            pager->sharedFrames[j] = -1;
+        }
+
+        // Without sharing a page table entry needs a frame of its own, so there are never more in use than the shard
+        //  has slots.
+        pager->mappingCount = (long) processes * config->pagesPerProcess < pager->slotCount || pager->sharedPages > 0 || config->copyOnWrite
+                              ? processes * config->pagesPerProcess : pager->slotCount;
+        pager->mappings = (Mapping*) allocateTable ( pager->mappingCount * sizeof ( Mapping ) );
+        for ( j = 0; pager->mappings != NULL && j < pager->mappingCount; ++j ) {
+            pager->mappings[j].next = j + 1 < pager->mappingCount ? j + 1 : -1;
+        }
+        pager->freeMapping = 0;
+        pager->residentLists = (int*) malloc ( processes * sizeof ( int ) );
+        for ( j = 0; pager->residentLists != NULL && j < processes; ++j ) {
+            pager->residentLists[j] = -1;
+        }
+        pager->workingSetWindow = config->workingSetWindow;
+        pager->stats = ( config->stats != NULL ) ? &config->stats->shards[i] : NULL;
+        if ( i > 0 ) {
+            pager->residentPages = group[0]->residentPages;
+            pager->workingSets = group[0]->workingSets;
+            pager->windowPages = group[0]->windowPages;
+            pager->windowReferences = group[0]->windowReferences;
+            pager->referencedFrames = group[0]->referencedFrames;
+            pager->prefetchedFrames = group[0]->prefetchedFrames;
+            pager->reverseMaps = group[0]->reverseMaps;
+            pager->mapCounts = group[0]->mapCounts;
+            pager->frameSlots = group[0]->frameSlots;
+        } else {
+            if ( config->stats != NULL ) {
+                pager->residentPages = statsResidentPages ( config->stats );
+                pager->workingSets = statsWorkingSets ( config->stats );
+            } else {
+                pager->residentPages = (int*) calloc ( config->processes, sizeof ( int ) );
+                pager->workingSets = (int*) calloc ( config->processes, sizeof ( int ) );
+            }
+            pager->windowPages = (int*) calloc ( config->processes, sizeof ( int ) );
+            pager->windowReferences = (int*) calloc ( config->processes, sizeof ( int ) );
+            pager->referencedFrames = (unsigned char*) allocateTable ( config->frames );
+            pager->prefetchedFrames = (unsigned char*) allocateTable ( config->frames );
+            pager->reverseMaps = (int*) allocateTable ( config->frames * sizeof ( int ) );
+            pager->mapCounts = (int*) allocateTable ( config->frames * sizeof ( int ) );
+            pager->frameSlots = ( shards > 1 ) ? (int*) allocateTable ( config->frames * sizeof ( int ) ) : NULL;
+        }
+        if ( pager->policy == NULL || pager->pageTable == NULL || frameTable == NULL || pager->buddy == NULL || pager->residentPages == NULL || pager->workingSets == NULL
+             || pager->windowPages == NULL || pager->windowReferences == NULL || pager->referencedFrames == NULL || pager->prefetchedFrames == NULL
+             || pager->sharedFrames == NULL || pager->mappings == NULL || pager->residentLists == NULL || pager->reverseMaps == NULL || pager->mapCounts == NULL
+             || pager->hugeRegions == NULL || pager->hugeCounts == NULL || pager->regionPages == NULL || pager->hotRegions == NULL
+             || pager->slotFrames == NULL || pager->freeSlots == NULL || ( shards > 1 && pager->frameSlots == NULL )
+             || ( ( pager->sharedPages > 0 || config->copyOnWrite ) && !pager->pageTable->sharesFrames )
+             || ( prefetcherWanted ( config->prefetch ) && pager->prefetcher == NULL ) ) {
+            destroyPagerGroup ( group, i + 1 );
+            return false;
+        }
+    }
+
+    // Frame Table
+    // After initializing, every frame is unoccupied and free in the buddy allocator of the shard that owns it.
+    //  Frames are freed in reverse so each shard hands out its first frame first.
+    for ( i = config->frames - 1; i >= 0; --i ) {
+        freeFrame ( group[0], i );
+    }
+
+    return true;
+}
+
+void destroyPagerGroup ( Pager** group, int shards ) {
+    int i;
+
+    for ( i = 0; i < shards; ++i ) {
+        destroyPager ( group[i] );
+    }
+}
+
+// Function to free a pager. The first pager of a group owns the shared frame table.
+void destroyPager ( Pager* pager ) {
+    if ( pager->policy != NULL ) {
+        destroyPolicy ( pager->policy );
+    }
+    if ( pager->pageTable != NULL ) {
+        destroyPageTable ( pager->pageTable );
+    }
+    if ( pager->tlb != NULL ) {
+        destroyTlb ( pager->tlb );
+    }
+    if ( pager->prefetcher != NULL ) {
+        destroyPrefetcher ( pager->prefetcher );
+    }
+    if ( pager->shard == 0 ) {
+        freeTable ( pager->frameTable, pager->frames * sizeof ( Frame ) );
+        if ( pager->stats == NULL ) {
+            free ( pager->residentPages );
+            free ( pager->workingSets );
+        }
+        free ( pager->windowPages );
+        free ( pager->windowReferences );
+        freeTable ( pager->referencedFrames, pager->frames );
+        freeTable ( pager->prefetchedFrames, pager->frames );
+        freeTable ( pager->reverseMaps, pager->frames * sizeof ( int ) );
+        freeTable ( pager->mapCounts, pager->frames * sizeof ( int ) );
+        if ( pager->frameSlots != NULL ) {
+            freeTable ( pager->frameSlots, pager->frames * sizeof ( int ) );
+        }
+    }
+    freeTable ( pager->mappings, pager->mappingCount * sizeof ( Mapping ) );
+    free ( pager->sharedFrames );
+    if ( pager->buddy != NULL ) {
+        destroyBuddy ( pager->buddy );
+    }
+    free ( pager->residentLists );
+    free ( pager->hugeRegions );
+    free ( pager->hugeCounts );
+    free ( pager->regionPages );
+    free ( pager->hotRegions );
+    free ( pager->slotFrames );
+    free ( pager->freeSlots );
+    pthread_mutex_destroy ( &pager->lock );
+    pthread_mutex_destroy ( &pager->freeLock );
+    free ( pager );
+}
+
+// Function to resolve one memory reference. The TLB is checked first, then the page tables are walked.
+//  If the page is loaded (or is a shared segment page another process loaded) it is a hit, unless it is a
+//  write to a copy-on-write page, which is copied. Otherwise it is a page fault: the page goes into a free
+//  frame if there is one, or into a frame picked by the replacement policy, and the page tables (and TLBs)
+//  of the processes that had it are updated. In a group, a shard with no free frames takes one from another
+//  shard before evicting one of its own pages, and evicts another shard's page if it has none.
+static void referencePage ( Pager* pager, long pid, int blockIndex, int page, bool write, PagerResult* result ) {
+    struct timespec policyStart, policyEnd;
+    unsigned long key;
+    Frame* frame;
+
+    int local = blockIndex / pager->shards;
+    PHASE_STAMP ( phase );
+
+    pager->references++;
+    result->evicted = false;
+    result->prefetchHit = false;
+    result->prefetched = 0;
+    result->prefetchDirty = 0;
+    result->sharedMap = false;
+    result->copied = false;
+    result->demoted = false;
+    result->promoted = 0;
+    result->migrated = 0;
+    result->tlbHit = false;
+    result->walkAccesses = 0;
+
+    if ( pager->tlb != NULL ) {
+        pager->tlbReach += pager->tlb->reach[local];
+    }
+    if ( pager->tlb != NULL && ( result->frame = tlbLookup ( pager->tlb, local, page ) ) != -1 ) {
+        result->tlbHit = true;
+        pager->tlbHits++;
+    } else {
+        if ( pager->tlb != NULL ) {
+            pager->tlbMisses++;
+        }
+        result->frame = pager->pageTable->lookup ( pager->pageTable, local, page, &result->walkAccesses );
+        pager->walkAccesses += result->walkAccesses;
+        if ( result->frame != -1 && pager->tlb != NULL && isHuge ( pager, local, page ) ) {
+            tlbInsertHuge ( pager->tlb, local, page & ~( pager->hugePages - 1 ), result->frame - ( page & ( pager->hugePages - 1 ) ) );
+        } else if ( result->frame != -1 && pager->tlb != NULL ) {
+            tlbInsert ( pager->tlb, local, page, result->frame );
+        }
+    }
+    PHASE_END ( PHASE_LOOKUP, phase );
+
+    // A shared segment page another process has loaded only has to be mapped.
+    if ( result->frame == -1 && page < pager->sharedPages && pager->sharedFrames[page] != -1 ) {
+        result->frame = pager->sharedFrames[page];
+        addMapping ( pager, result->frame, local, page );
+        if ( pager->tlb != NULL ) {
+            tlbInsert ( pager->tlb, local, page, result->frame );
+        }
+        pager->sharedMaps++;
+        result->sharedMap = true;
+        countSaved ( pager );
+    }
+
+    // Hit. Tell the replacement policy the frame was just referenced.
+    if ( result->frame != -1 ) {
+        result->hit = true;
+
+        // A write to a page still shared after a fork gets the process its own copy.
+        if ( write && page >= pager->sharedPages && pager->mapCounts[result->frame] > 1 ) {
+            result->dirty = false;
+            copyOnWrite ( pager, pid, local, page, result );
+            countWindowReference ( pager, pid, blockIndex, local, page, result );
+            publishStats ( pager );
+            return;
+        }
+
+        frame = &pager->frameTable[result->frame];
+        result->dirty = frame->dirtyBit;
+        if ( write && !frame->dirtyBit ) {
+            frame->dirtyBit = 1;
+            countDirty ( pager, 1 );
+        }
+        policyHit ( pager, result->frame );
+        if ( pager->prefetchedFrames[result->frame] ) {
+            pager->prefetchedFrames[result->frame] = 0;
+            pager->prefetchHits++;
+            pager->prefetcher->observe ( pager->prefetcher, local, page );
+            result->prefetchHit = true;
+        }
+        pager->referencedFrames[result->frame] = 1;
+        countWindowReference ( pager, pid, blockIndex, local, page, result );
+        publishStats ( pager );
+        return;
+    }
+
+    // Page fault.
+    pager->faults++;
+    result->hit = false;
+    result->dirty = false;
+    key = pageKey ( pid, page );
+
+    clock_gettime ( CLOCK_MONOTONIC, &policyStart );
+
+    if ( pager->prefetcher != NULL ) {
+        pager->prefetcher->observe ( pager->prefetcher, local, page );
+        prefetchPages ( pager, pid, blockIndex, local, page, result );
+    }
+
+    result->frame = takeFrame ( pager, key, result );
+    PHASE_END ( PHASE_VICTIM, phase );
+
+    // Update frame with info of new page and map it in the process's page table.
+    frame = &pager->frameTable[result->frame];
+    frame->occupiedBit = 1;
+    frame->dirtyBit = write;
+    if ( write ) {
+        countDirty ( pager, 1 );
+    }
+    frame->blockIndex = blockIndex;
+    frame->processPage = page;
+    addMapping ( pager, result->frame, local, page );
+    if ( page < pager->sharedPages ) {
+        pager->sharedFrames[page] = result->frame;
+    }
+    if ( pager->tlb != NULL ) {
+        tlbInsert ( pager->tlb, local, page, result->frame );
+    }
+    policyInsert ( pager, result->frame, key );
+    pager->residentFrames++;
+    pager->referencedFrames[result->frame] = 1;
+    countWindowReference ( pager, pid, blockIndex, local, page, result );
+    publishStats ( pager );
+
+    clock_gettime ( CLOCK_MONOTONIC, &policyEnd );
+    pager->policyNanoseconds += ( policyEnd.tv_sec - policyStart.tv_sec ) * 1e9 + ( policyEnd.tv_nsec - policyStart.tv_nsec );
+}
+
+// Function to resolve one memory reference for a PCB slot in the pager's shard (see referencePage). Pagers
+//  in a group hold their lock while they do, since other shards can steal their frames.
+void pagerReference ( Pager* pager, long pid, int blockIndex, int page, bool write, PagerResult* result ) {
+    if ( pager->group == NULL ) {
+        referencePage ( pager, pid, blockIndex, page, write, result );
+        return;
+    }
+
+    pthread_mutex_lock ( &pager->lock );
+    referencePage ( pager, pid, blockIndex, page, write, result );
+    pthread_mutex_unlock ( &pager->lock );
+}
+
+// Function to clear every frame a process has loaded, based on what is stored in its page table.
+void pagerRelease ( Pager* pager, int blockIndex ) {
+    int local = blockIndex / pager->shards;
+    int frame, region;
+
+    if ( pager->group != NULL ) {
+        pthread_mutex_lock ( &pager->lock );
+    }
+
+    // Unmap each page it has loaded, then reset each frame no other process maps and put it back on the free stack.
+    while ( pager->residentLists[local] != -1 ) {
+        frame = pager->mappings[pager->residentLists[local]].frame;
+        removeMapping ( pager, pager->residentLists[local] );
+        if ( pager->mapCounts[frame] > 0 ) {
+            continue;
+        }
+        policyFree ( pager, frame );
+        if ( pager->frameTable[frame].dirtyBit ) {
+            countDirty ( pager, -1 );
+        }
+        if ( pager->prefetchedFrames[frame] ) {
+            pager->prefetchWasted++;
+        }
+        if ( pager->frameTable[frame].processPage < pager->sharedPages ) {
+            pager->sharedFrames[pager->frameTable[frame].processPage] = -1;
+        }
+        freeFrame ( pager, frame );
+        pager->residentFrames--;
+    }
+
+    // Then drop the table entries of its huge pages, which stood in for their pages' own.
+    for ( region = 0; pager->hugeCounts[local] > 0 && region < pager->regions; ++region ) {
+        if ( pager->hugeRegions[(long) local * pager->regions + region] ) {
+            pager->pageTable->unmapHuge ( pager->pageTable, local, region << pager->hugeOrder );
+            pager->hugeRegions[(long) local * pager->regions + region] = 0;
+            pager->hugeCounts[local]--;
+            pager->hugeResident--;
+        }
+    }
+    statsStore ( pager->residentPages[blockIndex], 0 );
+    statsStore ( pager->workingSets[blockIndex], 0 );
+    pager->windowPages[blockIndex] = 0;
+    pager->windowReferences[blockIndex] = 0;
+    if ( pager->prefetcher != NULL ) {
+        pager->prefetcher->reset ( pager->prefetcher, local );
+    }
+    publishStats ( pager );
+
+    if ( pager->tlb != NULL ) {
+        tlbFlush ( pager->tlb, local );
+    }
+
+    if ( pager->group != NULL ) {
+        pthread_mutex_unlock ( &pager->lock );
+    }
+}
+
+
+// Function to pick a batch of dirty pages for the page cleaner and mark them clean, as if they had been written
+//  back. The hand moves around the shard's PCB slots to the next one with dirty pages that haven't been
+//  referenced in its current working set window. That is the kind the replacement policy is about to pick, and
+//  cleaning a page still in use is wasted since it is written again before it goes. The batch is up to limit of
+//  them, found on the slot's resident list (so only pages it has loaded are looked at), in page order.
+//  Their numbers go in pages and the slot's PCB index in blockIndex. Returns how many pages there are, 0 if the
+//  shard has nothing cold and dirty.
+int pagerClean ( Pager* pager, int limit, int* blockIndex, int* pages ) {
+    int i, j, entry, frame, page, local, count = 0;
+
+    if ( pager->group != NULL ) {
+        pthread_mutex_lock ( &pager->lock );
+    }
+
+    for ( i = 0; i < pager->processes && count == 0 && pager->dirtyFrames > 0; ++i ) {
+        local = ( pager->cleanHand + i ) % pager->processes;
+        *blockIndex = local * pager->shards + pager->shard;
+        if ( *blockIndex >= pager->slots || statsLoad ( pager->residentPages[*blockIndex] ) == 0 ) {
+            continue;
+        }
+
+        for ( entry = pager->residentLists[local]; entry != -1 && count < limit; entry = pager->mappings[entry].processNext ) {
+            frame = pager->mappings[entry].frame;
+            if ( !pager->frameTable[frame].dirtyBit || pager->referencedFrames[frame] ) {
+                continue;
+            }
+            pager->frameTable[frame].dirtyBit = 0;
+            countDirty ( pager, -1 );
+
+            // Keep the batch in page order as it grows. It is at most limit pages.
+            page = pager->mappings[entry].page;
+            for ( j = count++; j > 0 && pages[j - 1] > page; --j ) {
+                pages[j] = pages[j - 1];
+            }
+            pages[j] = page;
+        }
+        pager->cleanHand = ( local + 1 ) % pager->processes;
+    }
+    publishStats ( pager );
+
+    if ( pager->group != NULL ) {
+        pthread_mutex_unlock ( &pager->lock );
+    }
+    return count;
+}
+
+// Function to simulate a fork: every page the parent has loaded is mapped into the child, which must have
+//  nothing loaded, in the same frame. Both are in the pager's shard. The pages stay shared until one of the
+//  processes writes to one (see copyOnWrite). Returns how many pages were shared copy-on-write, not counting the
+//  shared segment, which the child would share anyway.
+int pagerFork ( Pager* pager, int parentIndex, int childIndex ) {
+    int parent = parentIndex / pager->shards, child = childIndex / pager->shards;
+    int entry, count = 0;
+
+    if ( pager->group != NULL ) {
+        pthread_mutex_lock ( &pager->lock );
+    }
+
+    // Huge pages are never shared, so the parent's are split up first.
+    for ( entry = pager->residentLists[parent]; pager->hugeCounts[parent] > 0 && entry != -1; entry = pager->mappings[entry].processNext ) {
+        if ( isHuge ( pager, parent, pager->mappings[entry].page ) ) {
+            demoteRegion ( pager, parent, pager->mappings[entry].page, pager->mappings[entry].frame );
+        }
+    }
+
+    for ( entry = pager->residentLists[parent]; entry != -1; entry = pager->mappings[entry].processNext ) {
+        addMapping ( pager, pager->mappings[entry].frame, child, pager->mappings[entry].page );
+        if ( pager->mappings[entry].page >= pager->sharedPages ) {
+            count++;
+        }
+    }
+    pager->forks++;
+    pager->forkedPages += count;
+    countSaved ( pager );
+    publishStats ( pager );
+
+    if ( pager->group != NULL ) {
+        pthread_mutex_unlock ( &pager->lock );
+    }
+    return count;
+}
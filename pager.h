@@ -0,0 +1,249 @@
+// File name: pager.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the paging logic: the frame table, the page tables (see pagetable.c),
+//  the TLB (see tlb.c) and what happens on a memory reference. OSS drives one pager from its main loop; trace
+//  replay can drive several at once (one per thread), so a pager keeps all of its state
+//  in its own structure.
+//
+// With worker threads (oss -w) OSS uses a group of pagers instead, one per shard of PCB slots
+//  (slot i belongs to shard i % shards). They share one frame table, but each shard owns a range
+//  of its frames and has its own free list for them, replacement policy, page tables, TLB and lock,
+//  so workers only touch each other's state when a shard runs out of frames and has to steal one.
+//
+// Processes can share frames: the first sharedPages pages of every process are one shared segment
+//  (oss -H), and a simulated fork (pagerFork) maps the parent's loaded pages into the child copy-on-write
+//  (oss -k). Every frame has a reverse map of the page table entries that point at it, so evicting it unmaps
+//  it from every process. Only processes in the same shard share, so with several shards each has its own
+//  copy of the shared segment and the reverse maps never cross a lock.
+//
+// Pages can also be huge (oss -G): a process's address space is cut into regions of hugePages pages, and a
+//  region whose pages are all loaded and were all referenced in the process's last working set window is
+//  promoted to one huge page in an aligned run of frames, which takes one TLB entry, and one page table
+//  entry where the page table has one that size (see pagetable.c). Free frames are kept in a buddy allocator (see buddy.h) so such runs can be found. A huge page is
+//  demoted back to base pages when one of its frames is evicted, or its process forks.
+
+#ifndef pager_h
+#define pager_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "policy.h"
+#include "pagetable.h"
+#include "tlb.h"
+#include "stats.h"
+#include "prefetch.h"
+#include "buddy.h"
+
+
+/* Constants */
+// Default geometry. All of it can be changed on the oss command line.
+#define DEFAULT_FRAMES 256
+#define DEFAULT_PAGES_PER_PROCESS 32
+#define DEFAULT_PAGE_SIZE 1000
+#define DEFAULT_TLB_ENTRIES 16
+#define DEFAULT_TLB_WAYS 4
+
+// Largest geometry a Frame can describe.
+#define MAX_PAGER_PROCESSES ( 1 << 14 )
+#define MAX_PAGES_PER_PROCESS ( 1 << 16 )
+
+
+/* Structures */
+// Frame Table
+// Structure to help define the frame table. Each instance will represent a frame in the frame table.
+//    Packed into 32 bits so a sweep over the table covers 16 frames per cache line, which is what limits the PCB to
+//    MAX_PAGER_PROCESSES slots and processes to MAX_PAGES_PER_PROCESS pages. The frame stores the PCB
+//    index of the process that loaded it (or of one that still maps it, if that one let go of it), so
+//    evicting it doesn't have to search pidArray. Every process mapping it is on its reverse map (see
+//    Mapping). Reference bits and any other replacement bookkeeping belong to the replacement policy (see
+//    policy.c).
+typedef struct {
+    unsigned int occupiedBit : 1;
+    unsigned int dirtyBit : 1;
+    unsigned int blockIndex : 14;
+    unsigned int processPage : 16;
+} Frame;
+
+// A page table entry in use: page of the PCB slot local (blockIndex / shards) is in frame. Each entry is on
+//  two lists: its frame's reverse map, through next and previous, and its slot's resident list, through
+//  processNext and processPrevious. So evicting a frame finds every process that maps it, and a process
+//  finds the pages it has loaded, both without looking at anything else. Unused entries are linked through
+//  next on the shard's free list.
+typedef struct {
+    int local;
+    int page;
+    int frame;
+    int next;
+    int previous;
+    int processNext;
+    int processPrevious;
+} Mapping;
+
+// What happened on a memory reference.
+typedef struct {
+    bool hit;                   // Page was already loaded.
+    bool tlbHit;                // Translation came from the TLB (no page walk).
+    int walkAccesses;           // Page table entries read by the page walk, 0 on a TLB hit.
+    bool dirty;                 // Frame's dirty bit before this reference.
+    int frame;                  // Frame the page is in now.
+    bool evicted;               // A page was replaced to make room.
+    int evictedBlockIndex;
+    int evictedPage;
+    bool evictedDirty;
+    bool prefetchHit;           // First reference to a page that was read ahead.
+    int prefetched;             // Pages read ahead on this fault, besides the one faulted on.
+    int prefetchPages[MAX_PREFETCH];
+    int prefetchFrames[MAX_PREFETCH];
+    unsigned int prefetchDirty; // Bit i is set if the frame for prefetchPages[i] held a dirty page.
+    bool sharedMap;             // Not loaded for this process, but the shared segment page was for another one.
+                                //  Mapped without I/O and counted as a hit.
+    bool copied;                // A write to a copy-on-write page. It was copied into frame (which may have
+                                //  meant evicting a page) and the copy is the process's own now.
+    bool demoted;               // The evicted page was part of a huge page, which was split up first.
+    int promoted;               // Huge pages the process was given at the end of its working set window.
+    int migrated;               // Pages copied into a run of frames for them.
+} PagerResult;
+
+// Everything needed to build a pager. A tlbEntries of 0 means no TLB.
+typedef struct {
+    int frames;
+    int processes;              // PCB slots.
+    int pagesPerProcess;
+    const char *policy;
+    const char *pageTable;
+    int tlbEntries;
+    int tlbWays;
+    int workingSetWindow;       // References per working set window (see Pager).
+    const char *prefetch;       // Prefetcher spec (see prefetch.h), NULL or "none" for none.
+    int sharedPages;            // Pages at the start of every process's address space that are a shared segment.
+    bool copyOnWrite;           // pagerFork will be used.
+    int hugePages;              // Pages in a huge page, a power of two, 0 for base pages only.
+    StatsSegment *stats;        // Live statistics segment to publish to, NULL for none.
+} PagerConfig;
+
+typedef struct Pager Pager;
+
+struct Pager {
+    int frames;
+    int processes;              // PCB slots in this pager's shard.
+    int slots;                  // PCB slots in the whole group.
+    int pagesPerProcess;
+    Frame *frameTable;          // Shared by every pager in a group. Frames store the global PCB index.
+    PageTable *pageTable;       // Page tables of every PCB slot in the shard, by blockIndex / shards.
+    Tlb *tlb;                   // NULL if there is no TLB.
+    Policy *policy;             // Tracks the frames holding this shard's pages.
+    Prefetcher *prefetcher;     // NULL if pages are only read in when they fault.
+
+    // Slots. A shard holds at most slotCount frames at once: the ones it starts out with, and as many again as an
+    //  even share taken from other shards. The policy (and a hashed page table) numbers the frames a shard holds by
+    //  slot, so its tables grow with the shard's share and not the whole frame table. slotFrames has the frame in
+    //  each slot, and frameSlots (by frame, shared by the group) the slot of each frame in the shard holding it. A
+    //  shard that can hold every frame uses the frame numbers as its slots.
+    int slotCount;
+    int *slotFrames;
+    int *freeSlots;             // Stack of the slots not in use.
+    int freeSlotCount;
+    int *frameSlots;
+
+    // Reverse maps. mappings is the shard's pool of page table entries, one for every page loaded by one of its
+    //  processes, so it only needs more entries than it has slots if pages are shared. reverseMaps holds the first
+    //  entry mapping each frame (-1 for none) and mapCounts how many there are. Both are by frame, shared by the
+    //  group, and only touched by the shard whose processes map the frame.
+    Mapping *mappings;
+    int mappingCount;
+    int freeMapping;            // Head of the free list, -1 if every entry is in use.
+    int *reverseMaps;
+    int *mapCounts;
+    int *residentLists;         // First entry of each PCB slot in the shard, by local index, -1 if none.
+    int sharedPages;
+    int *sharedFrames;          // Frame each page of the shard's shared segment is in, -1 if it isn't loaded.
+
+    // Free frames are kept in a buddy allocator, in runs as big as a huge page, so a free frame (or run) is
+    //  found in O(1) (O(log hugePages) to split a run). Once it runs dry the replacement policy picks a victim.
+    //  In a group it only holds the frames the shard owns, a range starting on a huge page boundary, and other
+    //  shards take from it and give frames back to it under freeLock.
+    Buddy *buddy;
+    long residentFrames;        // Frames holding this shard's pages.
+    long dirtyFrames;           // Of those, the ones with the dirty bit set. Read by the page cleaner in OSS.
+    int cleanHand;              // PCB slot in the shard the page cleaner looks at next (see pagerClean).
+    int *residentPages;         // Pages loaded for each PCB slot, by blockIndex. Shared by the group, and in the
+                                //  statistics segment if there is one.
+
+    // Working sets, measured over a window of workingSetWindow references by each PCB slot (Denning's
+    //  process virtual time). A frame's byte in referencedFrames is set whenever its page is referenced.
+    //  At the end of a slot's window its working set is the pages it referenced in it: the loaded ones with
+    //  the byte set, found through its page table, plus the ones evicted with it set, counted in windowPages.
+    //  The arrays are by blockIndex (frames for referencedFrames), shared by the group and only touched
+    //  under the lock of the shard that owns the slot.
+    int workingSetWindow;
+    unsigned char *referencedFrames;
+    int *windowReferences;      // References each PCB slot has made in its current window.
+    int *windowPages;
+    int *workingSets;           // Working set at the end of each PCB slot's last window, 0 before its first.
+                                //  In the statistics segment if there is one.
+    unsigned char *prefetchedFrames;    // Set on a frame whose page was read ahead and hasn't been referenced yet.
+                                        //  Shared by the group, by frame.
+
+    // Huge pages. Page p of a process is in region p / hugePages. Only whole regions outside the shared segment
+    //  are promoted, and a huge page's page i is always in frame i of its run, so every page of it stays on the
+    //  reverse maps and resident lists like any other.
+    int hugePages;              // 0 if there are none.
+    int hugeOrder;              // log2 of hugePages, the buddy allocator order of a huge page.
+    int regions;                // Whole regions in an address space.
+    unsigned char *hugeRegions; // By local * regions + region, set while the region is a huge page.
+    int *hugeCounts;            // Huge pages each PCB slot in the shard has, by local index.
+    int *regionPages;           // Scratch space for countWindowReference: pages referenced in each region,
+    int *hotRegions;            //  and the regions all of whose pages were.
+    // Shard group. A single pager is a group of one and never locks.
+    int shard;
+    int shards;
+    Pager **group;
+    pthread_mutex_t lock;
+    pthread_mutex_t freeLock;   // Only guards buddy, and is never held while taking another lock.
+
+    // Statistics
+    long references;
+    long faults;
+    long evictions;
+    long tlbHits;
+    long tlbMisses;
+    long walkAccesses;
+    double policyNanoseconds;   // Real time spent in the policy on page faults.
+    long steals;                // Frames taken from another shard.
+    long prefetches;            // Pages read ahead.
+    long prefetchHits;          // Of those, the ones referenced before they were evicted: page faults avoided.
+    long prefetchWasted;        // Of those, the ones evicted or freed without being referenced.
+    long sharedMaps;            // Shared segment pages mapped without I/O since another process had them loaded.
+    long forks;
+    long forkedPages;           // Pages of a parent mapped into its child copy-on-write.
+    long copies;                // Copy-on-write pages copied on a write.
+    long mappedPages;           // Page table entries in use. Less residentFrames, the frames sharing saves.
+    long peakSavedFrames;
+    long promotions;            // Regions made huge pages.
+    long promotedInPlace;       // Of those, the ones whose pages were already in a run of frames in order.
+    long migratedPages;         // Pages copied into a run of frames for the others.
+    long promotionFailures;     // Hot regions left alone because there was no free run of frames.
+    long demotions;             // Huge pages split back into base pages.
+    long hugeResident;          // Huge pages right now.
+    long peakHugeResident;
+    long tlbReach;              // Pages the referencing process's TLB covered, added up over every reference.
+    ShardStats *stats;          // Where the counters are published, NULL if they aren't.
+};
+
+
+/* Function Prototypes */
+Pager* createPager ( const PagerConfig* config );
+bool createPagerGroup ( const PagerConfig* config, int shards, Pager** group );
+void destroyPager ( Pager* pager );
+void destroyPagerGroup ( Pager** group, int shards );
+void pagerReference ( Pager* pager, long pid, int blockIndex, int page, bool write, PagerResult* result );
+void pagerRelease ( Pager* pager, int blockIndex );
+int pagerClean ( Pager* pager, int limit, int* blockIndex, int* pages );
+int pagerFork ( Pager* pager, int parentIndex, int childIndex );
+
+#endif
@@ -0,0 +1,462 @@
+// File name: pagetable.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Page table backends for the pager. See pagetable.h for the interface.
+//
+// Backends:
+//  flat   - One entry for every page of every PCB slot, all allocated up front (the original OSS
+//           page table). One read per lookup, but the size grows with slots x pages per process.
+//           A huge page just fills in the entries of its pages.
+//  radix  - Two levels: a directory per process pointing at leaves of RADIX_LEAF entries. Leaves
+//           (and the directory) only exist while the process has a page loaded in them. Two reads.
+//           A huge page of RADIX_LEAF pages or more is a directory entry per leaf it spans, so it
+//           costs no leaf and one read. A smaller one fills in its entries in the leaf.
+//  hashed - Inverted table: one entry per loaded page, from a pool of one per frame the pager can
+//           hold, found through a hash of (PCB index, page). The size only depends on the number of
+//           frames. One read for the hash bucket plus one per entry on the chain. A frame holds one
+//           page of one process, so nothing can be shared. A huge page is one entry, for its first
+//           frame, found through a second hash of its first page when a page isn't in the table on
+//           its own.
+
+#include "pagetable.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Shared helpers */
+// Function to keep the footprint numbers up to date.
+static void addBytes ( PageTable* table, long bytes ) {
+    table->bytes += bytes;
+    if ( table->bytes > table->peakBytes ) {
+        table->peakBytes = table->bytes;
+    }
+}
+
+
+/* Flat */
+// Entries hold frame + 1 so 0 means not loaded. That way the table can come straight from calloc
+//  and the kernel only hands out memory for the parts that get touched.
+typedef struct {
+    int *entries;
+} FlatState;
+
+static int flatLookup ( PageTable* table, int blockIndex, int page, int* accesses ) {
+    FlatState* s = (FlatState*) table->state;
+
+    *accesses = 1;
+    return s->entries[(long) blockIndex * table->pagesPerProcess + page] - 1;
+}
+
+static void flatMap ( PageTable* table, int blockIndex, int page, int frame ) {
+    FlatState* s = (FlatState*) table->state;
+
+    s->entries[(long) blockIndex * table->pagesPerProcess + page] = frame + 1;
+}
+
+static void flatUnmap ( PageTable* table, int blockIndex, int page ) {
+    FlatState* s = (FlatState*) table->state;
+
+    s->entries[(long) blockIndex * table->pagesPerProcess + page] = 0;
+}
+
+static void flatMapHuge ( PageTable* table, int blockIndex, int page, int frame ) {
+    int i;
+
+    for ( i = 0; i < table->hugePages; ++i ) {
+        flatMap ( table, blockIndex, page + i, frame + i );
+    }
+}
+
+static void flatUnmapHuge ( PageTable* table, int blockIndex, int page ) {
+    int i;
+
+    for ( i = 0; i < table->hugePages; ++i ) {
+        flatUnmap ( table, blockIndex, page + i );
+    }
+}
+
+static void flatDestroy ( PageTable* table ) {
+    FlatState* s = (FlatState*) table->state;
+
+    free ( s->entries );
+    free ( s );
+}
+
+static bool flatCreate ( PageTable* table ) {
+    FlatState* s = (FlatState*) malloc ( sizeof ( FlatState ) );
+    size_t entries = (size_t) table->processes * table->pagesPerProcess;
+
+    if ( ( s->entries = (int*) calloc ( entries, sizeof ( int ) ) ) == NULL ) {
+        free ( s );
+        return false;
+    }
+    addBytes ( table, entries * sizeof ( int ) );
+
+    table->state = s;
+    table->lookup = flatLookup;
+    table->map = flatMap;
+    table->unmap = flatUnmap;
+    table->mapHuge = flatMapHuge;
+    table->unmapHuge = flatUnmapHuge;
+    table->destroy = flatDestroy;
+    table->sharesFrames = true;
+    return true;
+}
+
+
+/* Two-level radix */
+#define RADIX_LEAF_BITS 10
+#define RADIX_LEAF ( 1 << RADIX_LEAF_BITS )     // 4KB of entries, like a real page table page.
+
+typedef struct {
+    int used;                   // Entries in use. The leaf is freed when it gets back to 0.
+    int entries[RADIX_LEAF];
+} RadixLeaf;
+
+typedef struct {
+    RadixLeaf ***directories;   // Per process. NULL while the process has nothing loaded.
+    int *leaves;                // Directory entries each process has in use: leaves and huge page entries.
+    int directorySize;
+} RadixState;
+
+// A directory entry with its low bit set maps the RADIX_LEAF pages it covers straight to a run of frames
+//  instead of pointing at a leaf. The rest of it is the run's first frame.
+#define RADIX_HUGE(entry) ( ( (uintptr_t) ( entry ) ) & 1 )
+#define RADIX_HUGE_ENTRY(frame) ( (RadixLeaf*) ( ( (uintptr_t) ( frame ) << 1 ) | 1 ) )
+#define RADIX_HUGE_FRAME(entry) ( (int) ( (uintptr_t) ( entry ) >> 1 ) )
+
+static int radixLookup ( PageTable* table, int blockIndex, int page, int* accesses ) {
+    RadixState* s = (RadixState*) table->state;
+    RadixLeaf** directory = s->directories[blockIndex];
+    RadixLeaf* leaf;
+
+    *accesses = 1;
+    if ( directory == NULL || ( leaf = directory[page >> RADIX_LEAF_BITS] ) == NULL ) {
+        return -1;
+    }
+    if ( RADIX_HUGE ( leaf ) ) {
+        return RADIX_HUGE_FRAME ( leaf ) + ( page & ( RADIX_LEAF - 1 ) );
+    }
+
+    *accesses = 2;
+    return leaf->entries[page & ( RADIX_LEAF - 1 )];
+}
+
+// Function to get the directory of a process, making it if it has none.
+static RadixLeaf** radixDirectory ( PageTable* table, int blockIndex ) {
+    RadixState* s = (RadixState*) table->state;
+
+    if ( s->directories[blockIndex] == NULL ) {
+        s->directories[blockIndex] = (RadixLeaf**) calloc ( s->directorySize, sizeof ( RadixLeaf* ) );
+        addBytes ( table, s->directorySize * sizeof ( RadixLeaf* ) );
+    }
+    return s->directories[blockIndex];
+}
+
+// Function to clear a directory entry, and free the directory too if that was the last one in use.
+static void radixClear ( PageTable* table, int blockIndex, int page ) {
+    RadixState* s = (RadixState*) table->state;
+
+    s->directories[blockIndex][page >> RADIX_LEAF_BITS] = NULL;
+    if ( --s->leaves[blockIndex] == 0 ) {
+        free ( s->directories[blockIndex] );
+        s->directories[blockIndex] = NULL;
+        addBytes ( table, - (long) ( s->directorySize * sizeof ( RadixLeaf* ) ) );
+    }
+}
+
+static void radixMap ( PageTable* table, int blockIndex, int page, int frame ) {
+    RadixState* s = (RadixState*) table->state;
+    RadixLeaf** directory = radixDirectory ( table, blockIndex );
+    RadixLeaf* leaf;
+    int i;
+
+    if ( ( leaf = directory[page >> RADIX_LEAF_BITS] ) == NULL ) {
+        leaf = directory[page >> RADIX_LEAF_BITS] = (RadixLeaf*) malloc ( sizeof ( RadixLeaf ) );
+        leaf->used = 0;
+        for ( i = 0; i < RADIX_LEAF; ++i ) {
+            leaf->entries[i] = -1;
+        }
+        s->leaves[blockIndex]++;
+        addBytes ( table, sizeof ( RadixLeaf ) );
+    }
+
+    leaf->entries[page & ( RADIX_LEAF - 1 )] = frame;
+    leaf->used++;
+}
+
+static void radixUnmap ( PageTable* table, int blockIndex, int page ) {
+    RadixLeaf* leaf = ( (RadixState*) table->state )->directories[blockIndex][page >> RADIX_LEAF_BITS];
+
+    leaf->entries[page & ( RADIX_LEAF - 1 )] = -1;
+    if ( --leaf->used > 0 ) {
+        return;
+    }
+
+    // Last page in the leaf. Free it, and the directory too if that was its last leaf.
+    free ( leaf );
+    addBytes ( table, - (long) sizeof ( RadixLeaf ) );
+    radixClear ( table, blockIndex, page );
+}
+
+// A huge page of at least a leaf's pages is a directory entry per leaf it spans, in place of the leaves (as
+//  a 2M page on x86 is a PMD entry in place of a page table page), so it costs no leaf and one read. A smaller
+//  one has no level of its own and just fills in its entries in the leaf.
+static void radixMapHuge ( PageTable* table, int blockIndex, int page, int frame ) {
+    RadixState* s = (RadixState*) table->state;
+    int i;
+
+    if ( table->hugePages < RADIX_LEAF ) {
+        for ( i = 0; i < table->hugePages; ++i ) {
+            radixMap ( table, blockIndex, page + i, frame + i );
+        }
+        return;
+    }
+    for ( i = 0; i < table->hugePages; i += RADIX_LEAF ) {
+        radixDirectory ( table, blockIndex )[( page + i ) >> RADIX_LEAF_BITS] = RADIX_HUGE_ENTRY ( frame + i );
+        s->leaves[blockIndex]++;
+    }
+}
+
+static void radixUnmapHuge ( PageTable* table, int blockIndex, int page ) {
+    int i;
+
+    if ( table->hugePages < RADIX_LEAF ) {
+        for ( i = 0; i < table->hugePages; ++i ) {
+            radixUnmap ( table, blockIndex, page + i );
+        }
+        return;
+    }
+    for ( i = 0; i < table->hugePages; i += RADIX_LEAF ) {
+        radixClear ( table, blockIndex, page + i );
+    }
+}
+
+static void radixDestroy ( PageTable* table ) {
+    RadixState* s = (RadixState*) table->state;
+    int i, d;
+
+    for ( i = 0; i < table->processes; ++i ) {
+        for ( d = 0; s->directories[i] != NULL && d < s->directorySize; ++d ) {
+            if ( !RADIX_HUGE ( s->directories[i][d] ) ) {
+                free ( s->directories[i][d] );
+            }
+        }
+        free ( s->directories[i] );
+    }
+    free ( s->directories );
+    free ( s->leaves );
+    free ( s );
+}
+
+static bool radixCreate ( PageTable* table ) {
+    RadixState* s = (RadixState*) malloc ( sizeof ( RadixState ) );
+
+    s->directorySize = ( table->pagesPerProcess + RADIX_LEAF - 1 ) / RADIX_LEAF;
+    s->directories = (RadixLeaf***) calloc ( table->processes, sizeof ( RadixLeaf** ) );
+    s->leaves = (int*) calloc ( table->processes, sizeof ( int ) );
+    addBytes ( table, table->processes * ( sizeof ( RadixLeaf** ) + sizeof ( int ) ) );
+
+    table->state = s;
+    table->lookup = radixLookup;
+    table->map = radixMap;
+    table->unmap = radixUnmap;
+    table->mapHuge = radixMapHuge;
+    table->unmapHuge = radixUnmapHuge;
+    table->destroy = radixDestroy;
+    table->sharesFrames = true;
+    return true;
+}
+
+
+/* Hashed (inverted) */
+// Entries not in use are linked through next on the free list. Buckets hold the first entry on their chain. A huge
+//  page is kept in an entry for its first frame under the page number ~page (never a page of its own), so the same
+//  hash finds it.
+typedef struct {
+    int blockIndex;
+    int page;
+    int frame;
+    int next;
+} InvertedEntry;
+
+typedef struct {
+    InvertedEntry *entries;
+    int *buckets;
+    unsigned int mask;
+    int freeEntry;              // Head of the free list, -1 if every entry is in use.
+} HashedState;
+
+static unsigned int hashedBucket ( HashedState* s, int blockIndex, int page ) {
+    unsigned int h = (unsigned int) blockIndex * 0x9E3779B1u ^ (unsigned int) page;
+
+    h ^= h >> 15;
+    h *= 0x85EBCA77u;
+    h ^= h >> 13;
+    return h & s->mask;
+}
+
+// Function to find the frame in the entry for (blockIndex, page), adding the entries read to accesses.
+static int hashedFind ( HashedState* s, int blockIndex, int page, int* accesses ) {
+    int entry = s->buckets[hashedBucket ( s, blockIndex, page )];
+
+    for ( ( *accesses )++; entry != -1; entry = s->entries[entry].next ) {
+        ( *accesses )++;
+        if ( s->entries[entry].blockIndex == blockIndex && s->entries[entry].page == page ) {
+            return s->entries[entry].frame;
+        }
+    }
+    return -1;
+}
+
+static int hashedLookup ( PageTable* table, int blockIndex, int page, int* accesses ) {
+    HashedState* s = (HashedState*) table->state;
+    int frame, first;
+
+    *accesses = 0;
+    if ( ( frame = hashedFind ( s, blockIndex, page, accesses ) ) != -1 || table->hugePages == 0 ) {
+        return frame;
+    }
+
+    first = page & ~( table->hugePages - 1 );
+    if ( ( frame = hashedFind ( s, blockIndex, ~first, accesses ) ) == -1 ) {
+        return -1;
+    }
+    return frame + ( page - first );
+}
+
+static void hashedMap ( PageTable* table, int blockIndex, int page, int frame ) {
+    HashedState* s = (HashedState*) table->state;
+    int* bucket = &s->buckets[hashedBucket ( s, blockIndex, page )];
+    int entry = s->freeEntry;
+
+    s->freeEntry = s->entries[entry].next;
+    s->entries[entry].blockIndex = blockIndex;
+    s->entries[entry].page = page;
+    s->entries[entry].frame = frame;
+    s->entries[entry].next = *bucket;
+    *bucket = entry;
+}
+
+static void hashedUnmap ( PageTable* table, int blockIndex, int page ) {
+    HashedState* s = (HashedState*) table->state;
+    int* link = &s->buckets[hashedBucket ( s, blockIndex, page )];
+    int entry;
+
+    while ( *link != -1 ) {
+        if ( s->entries[*link].blockIndex == blockIndex && s->entries[*link].page == page ) {
+            entry = *link;
+            *link = s->entries[entry].next;
+            s->entries[entry].next = s->freeEntry;
+            s->freeEntry = entry;
+            return;
+        }
+        link = &s->entries[*link].next;
+    }
+}
+
+static void hashedMapHuge ( PageTable* table, int blockIndex, int page, int frame ) {
+    hashedMap ( table, blockIndex, ~page, frame );
+}
+
+static void hashedUnmapHuge ( PageTable* table, int blockIndex, int page ) {
+    hashedUnmap ( table, blockIndex, ~page );
+}
+
+static void hashedDestroy ( PageTable* table ) {
+    HashedState* s = (HashedState*) table->state;
+
+    free ( s->entries );
+    free ( s->buckets );
+    free ( s );
+}
+
+static bool hashedCreate ( PageTable* table ) {
+    HashedState* s = (HashedState*) malloc ( sizeof ( HashedState ) );
+    unsigned int buckets = 1;
+    int i;
+
+    while ( buckets < (unsigned int) table->frames ) {
+        buckets <<= 1;
+    }
+    s->mask = buckets - 1;
+    s->entries = (InvertedEntry*) malloc ( table->frames * sizeof ( InvertedEntry ) );
+    s->buckets = (int*) malloc ( buckets * sizeof ( int ) );
+    if ( s->entries == NULL || s->buckets == NULL ) {
+        free ( s->entries );
+        free ( s->buckets );
+        free ( s );
+        return false;
+    }
+
+    for ( i = 0; i < table->frames; ++i ) {
+        s->entries[i].next = ( i + 1 < table->frames ) ? i + 1 : -1;
+    }
+    s->freeEntry = 0;
+    for ( i = 0; i < (int) buckets; ++i ) {
+        s->buckets[i] = -1;
+    }
+    addBytes ( table, table->frames * sizeof ( InvertedEntry ) + buckets * sizeof ( int ) );
+
+    table->state = s;
+    table->lookup = hashedLookup;
+    table->map = hashedMap;
+    table->unmap = hashedUnmap;
+    table->mapHuge = hashedMapHuge;
+    table->unmapHuge = hashedUnmapHuge;
+    table->destroy = hashedDestroy;
+    return true;
+}
+
+
+/* Function Definitions */
+
+// Table of the available backends. The first one is the default.
+static const struct {
+    const char *name;
+    bool ( *create ) ( PageTable* table );
+} pageTableTable[] = {
+    { "flat", flatCreate },
+    { "radix", radixCreate },
+    { "hashed", hashedCreate },
+};
+
+#define NUMBER_OF_PAGE_TABLES ( sizeof ( pageTableTable ) / sizeof ( pageTableTable[0] ) )
+
+// Function to create the page table backend with the given name, for huge pages of hugePages pages (0 for none).
+//  Returns NULL if there is no backend by that name or its tables can't be allocated.
+PageTable* createPageTable ( const char* name, int processes, int pagesPerProcess, int frames, int hugePages ) {
+    unsigned int i;
+    PageTable* table;
+
+    for ( i = 0; i < NUMBER_OF_PAGE_TABLES; ++i ) {
+        if ( strcmp ( name, pageTableTable[i].name ) == 0 ) {
+            table = (PageTable*) calloc ( 1, sizeof ( PageTable ) );
+            table->name = pageTableTable[i].name;
+            table->processes = processes;
+            table->pagesPerProcess = pagesPerProcess;
+            table->frames = frames;
+            table->hugePages = hugePages;
+            if ( !pageTableTable[i].create ( table ) ) {
+                free ( table );
+                return NULL;
+            }
+            return table;
+        }
+    }
+
+    return NULL;
+}
+
+void destroyPageTable ( PageTable* table ) {
+    table->destroy ( table );
+    free ( table );
+}
+
+// Function to get the names of every backend for help messages.
+const char* pageTableNames() {
+    return "flat, radix, hashed";
+}
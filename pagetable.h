@@ -0,0 +1,64 @@
+// File name: pagetable.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the page table backends used by the pager. Each backend maps a
+//  (PCB index, page) pair to a frame and counts how many table entries a lookup had to
+//  read, so the pager can charge a page walk, and how much memory the tables take up.
+//
+// With huge pages (oss -G) a run of hugePages pages, starting at a multiple of hugePages, can
+//  also be mapped to a run of as many frames at once. A backend keeps that in one entry where it
+//  can, which is where huge pages save table memory and page walk reads.
+
+#ifndef pagetable_h
+#define pagetable_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/* Structures */
+typedef struct PageTable PageTable;
+struct PageTable {
+    const char *name;
+    int processes;
+    int pagesPerProcess;
+    int frames;
+    int hugePages;              // Pages in a huge page (a power of two), 0 if there are none.
+    bool sharesFrames;          // A frame can be mapped by more than one process. Not for an inverted table,
+                                //  which has one entry per frame.
+    void *state;
+
+    // Memory the tables take up, in bytes, right now and at most so far.
+    size_t bytes;
+    size_t peakBytes;
+
+    // Look up the frame a page is loaded in. Returns -1 if it isn't loaded. accesses is set to the
+    //  number of table entries read on the way.
+    int ( *lookup ) ( PageTable* table, int blockIndex, int page, int* accesses );
+
+    // Record that the page is loaded in the frame.
+    void ( *map ) ( PageTable* table, int blockIndex, int page, int frame );
+
+    // Record that the page is no longer loaded. A process's pages are unmapped one by one when it terminates
+    //  (the pager knows which are loaded), so a backend frees whatever a process no longer needs here.
+    void ( *unmap ) ( PageTable* table, int blockIndex, int page );
+
+    // Record that the huge page starting at page is loaded in the frames starting at frame. None of its pages
+    //  are mapped on their own while it is.
+    void ( *mapHuge ) ( PageTable* table, int blockIndex, int page, int frame );
+
+    // Record that the huge page starting at page is no longer loaded as one.
+    void ( *unmapHuge ) ( PageTable* table, int blockIndex, int page );
+
+    void ( *destroy ) ( PageTable* table );
+};
+
+
+/* Function Prototypes */
+PageTable* createPageTable ( const char* name, int processes, int pagesPerProcess, int frames, int hugePages );
+void destroyPageTable ( PageTable* table );
+const char* pageTableNames ( void );
+
+#endif
@@ -0,0 +1,81 @@
+// File name: phasetime.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Phase timers for the OSS request loop. See phasetime.h.
+
+#include "phasetime.h"
+#include "histogram.h"
+
+
+/* Variables */
+bool phaseTimingOn = false;
+
+const char *phaseNames[PHASES] = { "receive", "lookup", "victim", "logging", "send" };
+Histogram phaseTimes[PHASES];   // Stamp ticks spent in each phase, recorded by any thread.
+
+uint64_t startStamp;            // Stamp and CLOCK_MONOTONIC ns when timing started, to scale ticks to ns.
+uint64_t startNanoseconds;
+
+
+/* Function Definitions */
+
+// Function to get CLOCK_MONOTONIC in ns.
+static uint64_t monotonicNanoseconds ( void ) {
+    struct timespec now;
+
+    clock_gettime ( CLOCK_MONOTONIC, &now );
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+// Function to start recording. Called once by OSS before it serves any request.
+void phaseTimingStart() {
+#ifndef NO_PHASE_TIMING
+    startStamp = phaseStamp();
+    startNanoseconds = monotonicNanoseconds();
+    phaseTimingOn = true;
+#endif
+}
+
+// Function to record the time from start to now in a phase's histogram. Returns now, the start of the next phase.
+uint64_t phaseEnd ( int phase, uint64_t start ) {
+    uint64_t now = phaseStamp();
+
+    histogramRecord ( &phaseTimes[phase], now - start, 1 );
+    return now;
+}
+
+// Function to print a line per phase: how many times it ran, its share of the timed total, and its mean and
+//  percentiles in ns. Safe to call while other threads are still recording.
+void phaseTimingDump ( FILE* out ) {
+    double nanosecondsPerTick, total = 0;
+    uint64_t ticks;
+    int i;
+
+#ifdef NO_PHASE_TIMING
+    fprintf ( out, "Phase timing: compiled out (built with PHASE_TIMING=0).\n" );
+    return;
+#endif
+    if ( !phaseTimingOn ) {
+        return;
+    }
+
+    ticks = phaseStamp() - startStamp;
+    nanosecondsPerTick = ticks > 0 ? (double) ( monotonicNanoseconds() - startNanoseconds ) / ticks : 1.0;
+
+    for ( i = 0; i < PHASES; ++i ) {
+        total += __atomic_load_n ( &phaseTimes[i].sum, __ATOMIC_RELAXED );
+    }
+
+    fprintf ( out, "Phase timing (real ns):   count     share      mean       p50       p99     p99.9       max\n" );
+    for ( i = 0; i < PHASES; ++i ) {
+        fprintf ( out, "  %-22s %9lu %8.1f%% %9.0f %9.0f %9.0f %9.0f %9.0f\n", phaseNames[i], __atomic_load_n ( &phaseTimes[i].total, __ATOMIC_RELAXED ),
+            total > 0 ? 100.0 * __atomic_load_n ( &phaseTimes[i].sum, __ATOMIC_RELAXED ) / total : 0.0,
+            histogramMean ( &phaseTimes[i] ) * nanosecondsPerTick,
+            histogramPercentile ( &phaseTimes[i], 50 ) * nanosecondsPerTick,
+            histogramPercentile ( &phaseTimes[i], 99 ) * nanosecondsPerTick,
+            histogramPercentile ( &phaseTimes[i], 99.9 ) * nanosecondsPerTick,
+            __atomic_load_n ( &phaseTimes[i].max, __ATOMIC_RELAXED ) * nanosecondsPerTick );
+    }
+    fflush ( out );
+}
@@ -0,0 +1,76 @@
+// File name: phasetime.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the phase timers: how much real time OSS spends in each part of serving a
+//  request, kept in one histogram per phase (see histogram.h) so the dump shows percentiles and
+//  not just a total. The phases are
+//
+//  receive     Waiting in msgrcv (or on the ring) for the next request.
+//  lookup      TLB and page table lookup of one reference.
+//  victim      Finding a frame for one page fault: a free frame, one stolen from another shard or a
+//              victim picked by the replacement policy.
+//  logging     Putting the events of one reference on the event log ring.
+//  send        msgsnd (or the ring) of one response.
+//
+// Stamps are the TSC (rdtsc) on x86 and CLOCK_MONOTONIC elsewhere. TSC ticks are turned into ns
+//  when the histograms are printed, from the ticks and ns that have passed since phaseTimingStart.
+//  Nothing is recorded until phaseTimingStart is called, so a replay or sweep sharing the pager
+//  doesn't pay for it. Building with -DNO_PHASE_TIMING (make PHASE_TIMING=0) compiles every stamp
+//  out.
+
+#ifndef phasetime_h
+#define phasetime_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined ( __x86_64__ ) || defined ( __i386__ )
+#include <x86intrin.h>
+#endif
+
+
+/* Constants */
+enum { PHASE_RECEIVE = 0, PHASE_LOOKUP, PHASE_VICTIM, PHASE_LOGGING, PHASE_SEND, PHASES };
+
+
+/* Variables */
+extern bool phaseTimingOn;
+
+
+/* Function Prototypes */
+void phaseTimingStart ( void );
+uint64_t phaseEnd ( int phase, uint64_t start );
+void phaseTimingDump ( FILE* out );
+
+
+/* Stamps */
+
+// Function to read the time stamp phases are measured with.
+static inline uint64_t phaseStamp ( void ) {
+#if defined ( __x86_64__ ) || defined ( __i386__ )
+    return __rdtsc();
+#else
+    struct timespec now;
+
+    clock_gettime ( CLOCK_MONOTONIC, &now );
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+// PHASE_STAMP declares a stamp, PHASE_MARK restarts it and PHASE_END records the time since it in a phase's
+//  histogram and restarts it there, so back to back phases take one read each.
+#ifdef NO_PHASE_TIMING
+#define PHASE_STAMP(stamp)
+#define PHASE_MARK(stamp)
+#define PHASE_END(phase, stamp)
+#else
+#define PHASE_STAMP(stamp) uint64_t stamp = phaseTimingOn ? phaseStamp() : 0
+#define PHASE_MARK(stamp) ( stamp = phaseTimingOn ? phaseStamp() : 0 )
+#define PHASE_END(phase, stamp) ( stamp = phaseTimingOn ? phaseEnd ( phase, stamp ) : 0 )
+#endif
+
+#endif
@@ -0,0 +1,895 @@
+// File name: policy.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Page replacement policies for OSS. See policy.h for the interface.
+//
+// Policies:
+//  fifo     - First in, first out.
+//  sc       - Second chance, done as a clock hand over the frames (the original OSS policy).
+//  lru      - LRU approximation using an aging counter per frame.
+//  clockpro - CLOCK-Pro. Hot/cold pages on one clock with three hands, plus non-resident
+//             cold pages kept for a test period to adapt the cold target.
+//  arc      - Adaptive Replacement Cache. Two resident lists (T1/T2) and two ghost lists
+//             (B1/B2) with an adaptive target size for T1.
+
+#include "policy.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Shared helpers */
+// Doubly-linked lists over node numbers. Lists are circular with a sentinel node, so
+//  the LRU end is next[sentinel] and the MRU end is prev[sentinel].
+typedef struct {
+    int *next;
+    int *prev;
+} Links;
+
+static void linksCreate ( Links* links, int nodes ) {
+    links->next = (int*) malloc ( nodes * sizeof ( int ) );
+    links->prev = (int*) malloc ( nodes * sizeof ( int ) );
+}
+
+static void linksDestroy ( Links* links ) {
+    free ( links->next );
+    free ( links->prev );
+}
+
+static void listInit ( Links* links, int sentinel ) {
+    links->next[sentinel] = sentinel;
+    links->prev[sentinel] = sentinel;
+}
+
+// Function to link node in right before at.
+static void listInsertBefore ( Links* links, int at, int node ) {
+    links->next[node] = at;
+    links->prev[node] = links->prev[at];
+    links->next[links->prev[at]] = node;
+    links->prev[at] = node;
+}
+
+static void listRemove ( Links* links, int node ) {
+    links->next[links->prev[node]] = links->next[node];
+    links->prev[links->next[node]] = links->prev[node];
+    links->next[node] = links->prev[node] = node;
+}
+
+// Hash index from page key to node number, used to find pages a policy remembers after
+//  evicting them. Chained, so removing a node is just unlinking it from its bucket.
+typedef struct {
+    int mask;
+    int *bucket;
+    int *chain;
+    unsigned long *key;
+} GhostIndex;
+
+static void ghostCreate ( GhostIndex* index, int nodes ) {
+    int buckets = 1;
+    int i;
+
+    while ( buckets < 2 * nodes ) {
+        buckets <<= 1;
+    }
+    index->mask = buckets - 1;
+    index->bucket = (int*) malloc ( buckets * sizeof ( int ) );
+    index->chain = (int*) malloc ( nodes * sizeof ( int ) );
+    index->key = (unsigned long*) calloc ( nodes, sizeof ( unsigned long ) );
+    for ( i = 0; i < buckets; ++i ) {
+        index->bucket[i] = -1;
+    }
+}
+
+static void ghostDestroy ( GhostIndex* index ) {
+    free ( index->bucket );
+    free ( index->chain );
+    free ( index->key );
+}
+
+static int ghostBucket ( GhostIndex* index, unsigned long key ) {
+    key ^= key >> 29;
+    key *= 0xbf58476d1ce4e5b9UL;
+    key ^= key >> 32;
+    return (int) ( key & index->mask );
+}
+
+static void ghostInsert ( GhostIndex* index, int node, unsigned long key ) {
+    int b = ghostBucket ( index, key );
+
+    index->key[node] = key;
+    index->chain[node] = index->bucket[b];
+    index->bucket[b] = node;
+}
+
+static void ghostRemove ( GhostIndex* index, int node ) {
+    int *link = &index->bucket[ghostBucket ( index, index->key[node] )];
+
+    while ( *link != -1 ) {
+        if ( *link == node ) {
+            *link = index->chain[node];
+            return;
+        }
+        link = &index->chain[*link];
+    }
+}
+
+static int ghostFind ( GhostIndex* index, unsigned long key ) {
+    int node = index->bucket[ghostBucket ( index, key )];
+
+    while ( node != -1 && index->key[node] != key ) {
+        node = index->chain[node];
+    }
+    return node;
+}
+
+
+/* FIFO */
+// Frames are kept in load order. The oldest one is always the victim.
+typedef struct {
+    Links links;        // Nodes 0 to frames - 1 are the frames, node frames is the sentinel.
+} FifoState;
+
+static int fifoSelectVictim ( Policy* policy, unsigned long key ) {
+    FifoState* s = (FifoState*) policy->state;
+    int victim = s->links.next[policy->frames];
+
+    listRemove ( &s->links, victim );
+    return victim;
+}
+
+static void fifoOnHit ( Policy* policy, int frame ) {
+}
+
+static void fifoOnInsert ( Policy* policy, int frame, unsigned long key ) {
+    FifoState* s = (FifoState*) policy->state;
+
+    listInsertBefore ( &s->links, policy->frames, frame );
+}
+
+static void fifoOnFree ( Policy* policy, int frame ) {
+    FifoState* s = (FifoState*) policy->state;
+
+    listRemove ( &s->links, frame );
+}
+
+static void fifoDestroy ( Policy* policy ) {
+    FifoState* s = (FifoState*) policy->state;
+
+    linksDestroy ( &s->links );
+    free ( s );
+}
+
+static void fifoCreate ( Policy* policy ) {
+    FifoState* s = (FifoState*) malloc ( sizeof ( FifoState ) );
+    int i;
+
+    linksCreate ( &s->links, policy->frames + 1 );
+    for ( i = 0; i <= policy->frames; ++i ) {
+        listInit ( &s->links, i );
+    }
+
+    policy->state = s;
+    policy->selectVictim = fifoSelectVictim;
+    policy->onHit = fifoOnHit;
+    policy->onInsert = fifoOnInsert;
+    policy->onFree = fifoOnFree;
+    policy->destroy = fifoDestroy;
+}
+
+
+/* Second chance */
+// The hand moves around the frames in a circle. A frame with its reference bit set gets a
+//  second chance: the bit is cleared and the hand moves on. The first occupied frame found
+//  with the bit clear is the victim.
+typedef struct {
+    unsigned char *referenceBit;
+    unsigned char *occupied;
+    int hand;
+} ClockState;
+
+static int clockSelectVictim ( Policy* policy, unsigned long key ) {
+    ClockState* s = (ClockState*) policy->state;
+    int victim;
+
+    while ( !s->occupied[s->hand] || s->referenceBit[s->hand] ) {
+        s->referenceBit[s->hand] = 0;
+        s->hand = ( s->hand + 1 ) % policy->frames;
+    }
+
+    victim = s->hand;
+    s->occupied[victim] = 0;
+    s->hand = ( s->hand + 1 ) % policy->frames;
+
+    return victim;
+}
+
+static void clockOnHit ( Policy* policy, int frame ) {
+    ClockState* s = (ClockState*) policy->state;
+
+    s->referenceBit[frame] = 1;
+}
+
+static void clockOnInsert ( Policy* policy, int frame, unsigned long key ) {
+    ClockState* s = (ClockState*) policy->state;
+
+    s->occupied[frame] = 1;
+    s->referenceBit[frame] = 1;
+}
+
+static void clockOnFree ( Policy* policy, int frame ) {
+    ClockState* s = (ClockState*) policy->state;
+
+    s->occupied[frame] = 0;
+    s->referenceBit[frame] = 0;
+}
+
+static void clockDestroy ( Policy* policy ) {
+    ClockState* s = (ClockState*) policy->state;
+
+    free ( s->referenceBit );
+    free ( s->occupied );
+    free ( s );
+}
+
+static void clockCreate ( Policy* policy ) {
+    ClockState* s = (ClockState*) malloc ( sizeof ( ClockState ) );
+
+    s->referenceBit = (unsigned char*) calloc ( policy->frames, 1 );
+    s->occupied = (unsigned char*) calloc ( policy->frames, 1 );
+    s->hand = 0;
+
+    policy->state = s;
+    policy->selectVictim = clockSelectVictim;
+    policy->onHit = clockOnHit;
+    policy->onInsert = clockOnInsert;
+    policy->onFree = clockOnFree;
+    policy->destroy = clockDestroy;
+}
+
+
+/* LRU approximation (aging) */
+// Every AGING_INTERVAL references each occupied frame's counter is shifted right and its
+//  reference bit is shifted in at the top. The frame with the smallest counter is the one
+//  used least recently (to within the resolution of the counter).
+#define AGING_INTERVAL 64
+
+typedef struct {
+    unsigned int *age;
+    unsigned char *referenceBit;
+    unsigned char *occupied;
+    int references;
+} AgingState;
+
+static void agingReference ( Policy* policy ) {
+    AgingState* s = (AgingState*) policy->state;
+    int i;
+
+    if ( ++s->references < AGING_INTERVAL ) {
+        return;
+    }
+
+    s->references = 0;
+    for ( i = 0; i < policy->frames; ++i ) {
+        s->age[i] = ( s->age[i] >> 1 ) | ( (unsigned int) s->referenceBit[i] << 31 );
+        s->referenceBit[i] = 0;
+    }
+}
+
+static int agingSelectVictim ( Policy* policy, unsigned long key ) {
+    AgingState* s = (AgingState*) policy->state;
+    int victim = -1;
+    int i;
+
+    for ( i = 0; i < policy->frames; ++i ) {
+        if ( s->occupied[i] && !s->referenceBit[i] && ( victim == -1 || s->age[i] < s->age[victim] ) ) {
+            victim = i;
+        }
+    }
+
+    // Every frame was referenced since the last tick. Fall back to the counters alone.
+    if ( victim == -1 ) {
+        for ( i = 0; i < policy->frames; ++i ) {
+            if ( s->occupied[i] && ( victim == -1 || s->age[i] < s->age[victim] ) ) {
+                victim = i;
+            }
+        }
+    }
+
+    s->occupied[victim] = 0;
+    return victim;
+}
+
+static void agingOnHit ( Policy* policy, int frame ) {
+    AgingState* s = (AgingState*) policy->state;
+
+    s->referenceBit[frame] = 1;
+    agingReference ( policy );
+}
+
+static void agingOnInsert ( Policy* policy, int frame, unsigned long key ) {
+    AgingState* s = (AgingState*) policy->state;
+
+    // A new page counts as referenced in the most recent tick so it isn't evicted right away.
+    s->occupied[frame] = 1;
+    s->referenceBit[frame] = 0;
+    s->age[frame] = 1u << 31;
+    agingReference ( policy );
+}
+
+static void agingOnFree ( Policy* policy, int frame ) {
+    AgingState* s = (AgingState*) policy->state;
+
+    s->occupied[frame] = 0;
+    s->referenceBit[frame] = 0;
+    s->age[frame] = 0;
+}
+
+static void agingDestroy ( Policy* policy ) {
+    AgingState* s = (AgingState*) policy->state;
+
+    free ( s->age );
+    free ( s->referenceBit );
+    free ( s->occupied );
+    free ( s );
+}
+
+static void agingCreate ( Policy* policy ) {
+    AgingState* s = (AgingState*) malloc ( sizeof ( AgingState ) );
+
+    s->age = (unsigned int*) calloc ( policy->frames, sizeof ( unsigned int ) );
+    s->referenceBit = (unsigned char*) calloc ( policy->frames, 1 );
+    s->occupied = (unsigned char*) calloc ( policy->frames, 1 );
+    s->references = 0;
+
+    policy->state = s;
+    policy->selectVictim = agingSelectVictim;
+    policy->onHit = agingOnHit;
+    policy->onInsert = agingOnInsert;
+    policy->onFree = agingOnFree;
+    policy->destroy = agingDestroy;
+}
+
+
+/* CLOCK-Pro */
+// Every resident page and up to frames non-resident cold pages sit on one circular list.
+//  New pages go in at the list head, which is right behind HAND_hot. Three hands move
+//  around it:
+//   HAND_cold - finds the victim. A cold page with its reference bit clear is evicted. A cold
+//               page referenced during its test period becomes hot, one referenced outside
+//               it starts a new test period.
+//   HAND_hot  - runs when there are too many hot pages. Demotes the first hot page with its
+//               reference bit clear and ends the test periods it passes.
+//   HAND_test - runs when there are too many non-resident pages and drops the oldest one.
+//  A page that faults back in during its test period grows the cold target, a test period
+//  that ends without a re-access shrinks it.
+typedef struct {
+    int nodes;
+    Links links;            // One circular list, no sentinel.
+    GhostIndex ghosts;      // Non-resident pages by key.
+    unsigned long *key;
+    int *frame;             // Frame holding the page, -1 if it is non-resident.
+    unsigned char *hot;
+    unsigned char *test;
+    unsigned char *referenceBit;
+    int *frameNode;         // Node holding each frame's page.
+    int *freeNodes;
+    int freeCount;
+    int handHot, handCold, handTest;
+    int hotCount, coldCount, nonResidentCount;
+    int coldTarget;
+} ClockProState;
+
+static int clockProNewNode ( ClockProState* s ) {
+    return s->freeNodes[--s->freeCount];
+}
+
+// Function to move any hand sitting on node to the next node, so the node can be unlinked.
+static void clockProStepHands ( ClockProState* s, int node ) {
+    int next = ( s->links.next[node] == node ) ? -1 : s->links.next[node];
+
+    if ( s->handHot == node ) s->handHot = next;
+    if ( s->handCold == node ) s->handCold = next;
+    if ( s->handTest == node ) s->handTest = next;
+}
+
+// Function to put a node at the list head (right behind HAND_hot).
+static void clockProLinkHead ( ClockProState* s, int node ) {
+    if ( s->handHot == -1 ) {
+        s->links.next[node] = s->links.prev[node] = node;
+        s->handHot = s->handCold = s->handTest = node;
+        return;
+    }
+    listInsertBefore ( &s->links, s->handHot, node );
+}
+
+static void clockProUnlink ( ClockProState* s, int node ) {
+    clockProStepHands ( s, node );
+    listRemove ( &s->links, node );
+}
+
+static void clockProRemove ( ClockProState* s, int node ) {
+    clockProUnlink ( s, node );
+    if ( s->frame[node] == -1 ) {
+        ghostRemove ( &s->ghosts, node );
+        s->nonResidentCount--;
+    }
+    s->freeNodes[s->freeCount++] = node;
+}
+
+static void clockProMoveToHead ( ClockProState* s, int node ) {
+    if ( s->links.next[node] == node ) {
+        return;
+    }
+    clockProUnlink ( s, node );
+    clockProLinkHead ( s, node );
+}
+
+static void clockProShrinkCold ( ClockProState* s ) {
+    if ( s->coldTarget > 1 ) {
+        s->coldTarget--;
+    }
+}
+
+static void clockProRunHandTest ( ClockProState* s ) {
+    int node;
+
+    while ( s->nonResidentCount > 0 ) {
+        node = s->handTest;
+        s->handTest = s->links.next[node];
+
+        if ( !s->hot[node] && s->test[node] ) {
+            s->test[node] = 0;
+            if ( s->frame[node] == -1 ) {
+                clockProShrinkCold ( s );
+                clockProRemove ( s, node );
+                return;
+            }
+        }
+    }
+}
+
+static void clockProRunHandHot ( ClockProState* s ) {
+    int node;
+
+    while ( s->hotCount > 0 ) {
+        node = s->handHot;
+        s->handHot = s->links.next[node];
+
+        if ( s->hot[node] ) {
+            if ( s->referenceBit[node] ) {
+                s->referenceBit[node] = 0;
+            } else {
+                s->hot[node] = 0;
+                s->test[node] = 0;
+                s->hotCount--;
+                s->coldCount++;
+                return;
+            }
+        } else if ( s->test[node] ) {
+            s->test[node] = 0;
+            if ( s->frame[node] == -1 ) {
+                clockProShrinkCold ( s );
+                clockProRemove ( s, node );
+            }
+        }
+    }
+}
+
+static int clockProSelectVictim ( Policy* policy, unsigned long key ) {
+    ClockProState* s = (ClockProState*) policy->state;
+    int node, victim;
+
+    while ( 1 ) {
+        // All resident pages are hot. Demote one so there is something to evict.
+        if ( s->coldCount == 0 ) {
+            clockProRunHandHot ( s );
+        }
+
+        node = s->handCold;
+        if ( s->frame[node] == -1 || s->hot[node] ) {
+            s->handCold = s->links.next[node];
+            continue;
+        }
+
+        // Cold page referenced during its test period: promote it to hot.
+        if ( s->referenceBit[node] && s->test[node] ) {
+            s->referenceBit[node] = 0;
+            s->test[node] = 0;
+            s->hot[node] = 1;
+            s->coldCount--;
+            s->hotCount++;
+            clockProMoveToHead ( s, node );
+            if ( s->hotCount > policy->capacity - s->coldTarget ) {
+                clockProRunHandHot ( s );
+            }
+            continue;
+        }
+
+        // Cold page referenced outside its test period: start a new one.
+        if ( s->referenceBit[node] ) {
+            s->referenceBit[node] = 0;
+            s->test[node] = 1;
+            clockProMoveToHead ( s, node );
+            continue;
+        }
+
+        // Cold page that wasn't referenced: evict it. If it is still in its test period it stays
+        //  on the list as a non-resident page.
+        victim = s->frame[node];
+        s->frameNode[victim] = -1;
+        s->coldCount--;
+        if ( s->test[node] ) {
+            s->handCold = s->links.next[node];
+            s->frame[node] = -1;
+            s->nonResidentCount++;
+            ghostInsert ( &s->ghosts, node, s->key[node] );
+            if ( s->nonResidentCount > policy->capacity ) {
+                clockProRunHandTest ( s );
+            }
+        } else {
+            clockProRemove ( s, node );
+        }
+        return victim;
+    }
+}
+
+static void clockProOnHit ( Policy* policy, int frame ) {
+    ClockProState* s = (ClockProState*) policy->state;
+
+    s->referenceBit[s->frameNode[frame]] = 1;
+}
+
+static void clockProOnInsert ( Policy* policy, int frame, unsigned long key ) {
+    ClockProState* s = (ClockProState*) policy->state;
+    int ghost = ghostFind ( &s->ghosts, key );
+    int node;
+
+    if ( ghost != -1 ) {
+        // Faulted back in during its test period, so the cold target was too small.
+        clockProRemove ( s, ghost );
+        if ( s->coldTarget < policy->capacity - 1 ) {
+            s->coldTarget++;
+        }
+    }
+
+    // The free list can run dry if frames were released while non-resident pages filled the list.
+    if ( s->freeCount == 0 ) {
+        clockProRunHandTest ( s );
+    }
+
+    node = clockProNewNode ( s );
+    s->key[node] = key;
+    s->frame[node] = frame;
+    s->referenceBit[node] = 0;
+    s->frameNode[frame] = node;
+    clockProLinkHead ( s, node );
+
+    if ( ghost != -1 ) {
+        s->hot[node] = 1;
+        s->test[node] = 0;
+        s->hotCount++;
+        if ( s->hotCount > policy->capacity - s->coldTarget ) {
+            clockProRunHandHot ( s );
+        }
+    } else {
+        s->hot[node] = 0;
+        s->test[node] = 1;
+        s->coldCount++;
+    }
+}
+
+static void clockProOnFree ( Policy* policy, int frame ) {
+    ClockProState* s = (ClockProState*) policy->state;
+    int node = s->frameNode[frame];
+
+    if ( s->hot[node] ) {
+        s->hotCount--;
+    } else {
+        s->coldCount--;
+    }
+    s->frameNode[frame] = -1;
+    clockProRemove ( s, node );
+}
+
+static void clockProDestroy ( Policy* policy ) {
+    ClockProState* s = (ClockProState*) policy->state;
+
+    linksDestroy ( &s->links );
+    ghostDestroy ( &s->ghosts );
+    free ( s->key );
+    free ( s->frame );
+    free ( s->hot );
+    free ( s->test );
+    free ( s->referenceBit );
+    free ( s->frameNode );
+    free ( s->freeNodes );
+    free ( s );
+}
+
+static void clockProCreate ( Policy* policy ) {
+    ClockProState* s = (ClockProState*) malloc ( sizeof ( ClockProState ) );
+    int i;
+
+    s->nodes = 2 * policy->frames + 1;
+    linksCreate ( &s->links, s->nodes );
+    ghostCreate ( &s->ghosts, s->nodes );
+    s->key = (unsigned long*) calloc ( s->nodes, sizeof ( unsigned long ) );
+    s->frame = (int*) malloc ( s->nodes * sizeof ( int ) );
+    s->hot = (unsigned char*) calloc ( s->nodes, 1 );
+    s->test = (unsigned char*) calloc ( s->nodes, 1 );
+    s->referenceBit = (unsigned char*) calloc ( s->nodes, 1 );
+    s->frameNode = (int*) malloc ( policy->frames * sizeof ( int ) );
+    s->freeNodes = (int*) malloc ( s->nodes * sizeof ( int ) );
+    s->freeCount = 0;
+    for ( i = s->nodes - 1; i >= 0; --i ) {
+        s->freeNodes[s->freeCount++] = i;
+    }
+    for ( i = 0; i < policy->frames; ++i ) {
+        s->frameNode[i] = -1;
+    }
+    s->handHot = s->handCold = s->handTest = -1;
+    s->hotCount = s->coldCount = s->nonResidentCount = 0;
+    s->coldTarget = ( policy->capacity / 10 > 1 ) ? policy->capacity / 10 : 1;
+
+    policy->state = s;
+    policy->selectVictim = clockProSelectVictim;
+    policy->onHit = clockProOnHit;
+    policy->onInsert = clockProOnInsert;
+    policy->onFree = clockProOnFree;
+    policy->destroy = clockProDestroy;
+}
+
+
+/* ARC */
+// T1 holds pages seen once recently, T2 pages seen at least twice. B1 and B2 remember the
+//  keys of pages recently evicted from T1 and T2. A miss that hits B1 means T1 should have
+//  been bigger, so the target p grows; a miss that hits B2 shrinks it. Nodes 0 to frames - 1
+//  are the resident pages (node number == frame), nodes frames to 2 * frames - 1 are ghosts,
+//  and the last four nodes are the list sentinels.
+enum { ARC_NONE = -1, ARC_T1, ARC_T2, ARC_B1, ARC_B2 };
+
+typedef struct {
+    Links links;
+    GhostIndex ghosts;
+    int sentinel[4];
+    int size[4];
+    signed char *list;          // Which list each node is on.
+    int *freeGhosts;
+    int freeGhostCount;
+    int target;                 // Target size of T1 (p).
+    int pendingGhost;           // Ghost hit found by selectVictim for the page about to be inserted.
+    unsigned long pendingKey;
+} ArcState;
+
+static void arcPush ( ArcState* s, int which, int node ) {
+    listInsertBefore ( &s->links, s->sentinel[which], node );
+    s->list[node] = which;
+    s->size[which]++;
+}
+
+static void arcUnlink ( ArcState* s, int node ) {
+    s->size[(int) s->list[node]]--;
+    s->list[node] = ARC_NONE;
+    listRemove ( &s->links, node );
+}
+
+static void arcDropGhost ( ArcState* s, int node ) {
+    arcUnlink ( s, node );
+    ghostRemove ( &s->ghosts, node );
+    s->freeGhosts[s->freeGhostCount++] = node;
+}
+
+static void arcDropLru ( ArcState* s, int which ) {
+    arcDropGhost ( s, s->links.next[s->sentinel[which]] );
+}
+
+// Function to evict the LRU page of T1 or T2 into the matching ghost list. Returns its frame.
+static int arcReplace ( Policy* policy, bool ghostInB2 ) {
+    ArcState* s = (ArcState*) policy->state;
+    int from, to, frame, ghost;
+
+    if ( s->size[ARC_T1] > 0 && ( s->size[ARC_T1] > s->target || ( ghostInB2 && s->size[ARC_T1] == s->target ) ) ) {
+        from = ARC_T1;
+        to = ARC_B1;
+    } else if ( s->size[ARC_T2] > 0 ) {
+        from = ARC_T2;
+        to = ARC_B2;
+    } else {
+        from = ARC_T1;
+        to = ARC_B1;
+    }
+
+    frame = s->links.next[s->sentinel[from]];
+    arcUnlink ( s, frame );
+
+    // Keep the ghost list within its bounds if frames were freed behind ARC's back.
+    if ( s->freeGhostCount == 0 ) {
+        arcDropLru ( s, ( s->size[ARC_B1] > s->size[ARC_B2] ) ? ARC_B1 : ARC_B2 );
+    }
+    ghost = s->freeGhosts[--s->freeGhostCount];
+    ghostInsert ( &s->ghosts, ghost, s->ghosts.key[frame] );
+    arcPush ( s, to, ghost );
+
+    return frame;
+}
+
+// Function to adapt the target on a ghost hit. Returns the ghost node, or -1 if key isn't a ghost.
+static int arcAdapt ( Policy* policy, unsigned long key ) {
+    ArcState* s = (ArcState*) policy->state;
+    int ghost = ghostFind ( &s->ghosts, key );
+    int delta;
+
+    if ( ghost == -1 ) {
+        return -1;
+    }
+
+    if ( s->list[ghost] == ARC_B1 ) {
+        delta = ( s->size[ARC_B2] > s->size[ARC_B1] ) ? s->size[ARC_B2] / s->size[ARC_B1] : 1;
+        s->target = ( s->target + delta < policy->capacity ) ? s->target + delta : policy->capacity;
+    } else {
+        delta = ( s->size[ARC_B1] > s->size[ARC_B2] ) ? s->size[ARC_B1] / s->size[ARC_B2] : 1;
+        s->target = ( s->target - delta > 0 ) ? s->target - delta : 0;
+    }
+
+    return ghost;
+}
+
+static int arcSelectVictim ( Policy* policy, unsigned long key ) {
+    ArcState* s = (ArcState*) policy->state;
+    int ghost = arcAdapt ( policy, key );
+    int l1, victim;
+
+    s->pendingGhost = ghost;
+    s->pendingKey = key;
+
+    if ( ghost != -1 ) {
+        return arcReplace ( policy, s->list[ghost] == ARC_B2 );
+    }
+
+    // Brand new page. Keep L1 = T1 + B1 within the capacity and the whole directory within twice that.
+    l1 = s->size[ARC_T1] + s->size[ARC_B1];
+    if ( l1 >= policy->capacity ) {
+        if ( s->size[ARC_B1] > 0 ) {
+            arcDropLru ( s, ARC_B1 );
+            return arcReplace ( policy, false );
+        }
+
+        // T1 alone fills memory. Its LRU page is evicted without being remembered.
+        victim = s->links.next[s->sentinel[ARC_T1]];
+        arcUnlink ( s, victim );
+        return victim;
+    }
+
+    if ( l1 + s->size[ARC_T2] + s->size[ARC_B2] >= 2 * policy->capacity && s->size[ARC_B2] > 0 ) {
+        arcDropLru ( s, ARC_B2 );
+    }
+    return arcReplace ( policy, false );
+}
+
+static void arcOnHit ( Policy* policy, int frame ) {
+    ArcState* s = (ArcState*) policy->state;
+
+    arcUnlink ( s, frame );
+    arcPush ( s, ARC_T2, frame );
+}
+
+static void arcOnInsert ( Policy* policy, int frame, unsigned long key ) {
+    ArcState* s = (ArcState*) policy->state;
+    int ghost;
+
+    // selectVictim already adapted for this page if memory was full. Otherwise do it here.
+    if ( s->pendingGhost != -1 && s->pendingKey == key ) {
+        ghost = s->pendingGhost;
+    } else if ( s->pendingKey == key ) {
+        ghost = -1;
+    } else {
+        ghost = arcAdapt ( policy, key );
+    }
+    s->pendingGhost = -1;
+    s->pendingKey = 0;
+
+    s->ghosts.key[frame] = key;
+    if ( ghost != -1 ) {
+        arcDropGhost ( s, ghost );
+        arcPush ( s, ARC_T2, frame );
+    } else {
+        arcPush ( s, ARC_T1, frame );
+    }
+}
+
+static void arcOnFree ( Policy* policy, int frame ) {
+    ArcState* s = (ArcState*) policy->state;
+
+    arcUnlink ( s, frame );
+}
+
+static void arcDestroy ( Policy* policy ) {
+    ArcState* s = (ArcState*) policy->state;
+
+    linksDestroy ( &s->links );
+    ghostDestroy ( &s->ghosts );
+    free ( s->list );
+    free ( s->freeGhosts );
+    free ( s );
+}
+
+static void arcCreate ( Policy* policy ) {
+    ArcState* s = (ArcState*) malloc ( sizeof ( ArcState ) );
+    int nodes = 2 * policy->frames + 4;
+    int i;
+
+    linksCreate ( &s->links, nodes );
+    ghostCreate ( &s->ghosts, nodes );
+    s->list = (signed char*) malloc ( nodes );
+    s->freeGhosts = (int*) malloc ( policy->frames * sizeof ( int ) );
+    s->freeGhostCount = 0;
+    for ( i = 0; i < nodes; ++i ) {
+        listInit ( &s->links, i );
+        s->list[i] = ARC_NONE;
+    }
+    for ( i = 2 * policy->frames - 1; i >= policy->frames; --i ) {
+        s->freeGhosts[s->freeGhostCount++] = i;
+    }
+    for ( i = 0; i < 4; ++i ) {
+        s->sentinel[i] = 2 * policy->frames + i;
+        s->size[i] = 0;
+    }
+    s->target = 0;
+    s->pendingGhost = -1;
+    s->pendingKey = 0;
+
+    policy->state = s;
+    policy->selectVictim = arcSelectVictim;
+    policy->onHit = arcOnHit;
+    policy->onInsert = arcOnInsert;
+    policy->onFree = arcOnFree;
+    policy->destroy = arcDestroy;
+}
+
+
+/* Function Definitions */
+
+// Table of the available policies. The first one is the default.
+static const struct {
+    const char *name;
+    void ( *create ) ( Policy* policy );
+} policyTable[] = {
+    { "sc", clockCreate },
+    { "fifo", fifoCreate },
+    { "lru", agingCreate },
+    { "clockpro", clockProCreate },
+    { "arc", arcCreate },
+};
+
+#define NUMBER_OF_POLICIES ( sizeof ( policyTable ) / sizeof ( policyTable[0] ) )
+
+// Function to create the policy with the given name for a frame table of the given size, of which it is
+//  expected to hold capacity frames at once. Returns NULL if there is no policy by that name.
+Policy* createPolicy ( const char* name, int frames, int capacity ) {
+    unsigned int i;
+    Policy* policy;
+
+    for ( i = 0; i < NUMBER_OF_POLICIES; ++i ) {
+        if ( strcmp ( name, policyTable[i].name ) == 0 ) {
+            policy = (Policy*) calloc ( 1, sizeof ( Policy ) );
+            policy->name = policyTable[i].name;
+            policy->frames = frames;
+            policy->capacity = ( capacity > 0 ) ? capacity : 1;
+            policyTable[i].create ( policy );
+            return policy;
+        }
+    }
+
+    return NULL;
+}
+
+void destroyPolicy ( Policy* policy ) {
+    policy->destroy ( policy );
+    free ( policy );
+}
+
+// Function to get the names of every policy for help messages.
+const char* policyNames() {
+    return "sc, fifo, lru, clockpro, arc";
+}
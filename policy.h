@@ -0,0 +1,56 @@
+// File name: policy.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the page replacement policies used by oss.c. Each policy keeps its
+//  own bookkeeping on the frames it is given, so oss.c only has to tell it what
+//  happened (hit, page loaded, frame freed) and ask it for a victim when memory is full.
+
+#ifndef policy_h
+#define policy_h
+
+#include <stdbool.h>
+
+
+/* Structures */
+// A replacement policy. Frames are numbered 0 to frames - 1. A page is identified by a key
+//  made from the owning process and page number (see pageKey) so policies that remember
+//  evicted pages (CLOCK-Pro, ARC) can tell when one comes back. Those two size their lists
+//  and targets from capacity, the frames the policy usually holds: all of them, or a pager
+//  shard's share of them.
+typedef struct Policy Policy;
+struct Policy {
+    const char *name;
+    int frames;
+    int capacity;
+    void *state;
+
+    // Pick a frame to evict to make room for the page with the given key. Only called when every
+    //  frame is occupied. The returned frame is no longer tracked by the policy.
+    int ( *selectVictim ) ( Policy* policy, unsigned long key );
+
+    // A page already loaded in the frame was referenced.
+    void ( *onHit ) ( Policy* policy, int frame );
+
+    // The page with the given key was loaded into the frame.
+    void ( *onInsert ) ( Policy* policy, int frame, unsigned long key );
+
+    // The frame was released without being evicted (its process terminated).
+    void ( *onFree ) ( Policy* policy, int frame );
+
+    void ( *destroy ) ( Policy* policy );
+};
+
+
+/* Function Prototypes */
+Policy* createPolicy ( const char* name, int frames, int capacity );
+void destroyPolicy ( Policy* policy );
+const char* policyNames ( void );
+
+// Function to make the key a policy uses to identify a page.
+static inline unsigned long pageKey ( long pid, int page ) {
+    return ( (unsigned long) pid << 32 ) | (unsigned int) page;
+}
+
+#endif
@@ -0,0 +1,242 @@
+// File name: prefetch.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Prefetchers for the pager. See prefetch.h for the interface.
+//
+// Prefetchers:
+//  seq    - Sequential read-ahead. Kicks in once a process references consecutive pages.
+//  stride - Stride detection per PCB slot. Sequential read-ahead is the stride 1 case.
+//  markov - First order Markov table per PCB slot: the page that last followed each page.
+
+#include "prefetch.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Sequential and stride */
+// Last page each slot referenced and how far it was from the one before it. A stride is confirmed
+//  when two references in a row are the same distance apart.
+typedef struct {
+    int *last;
+    int *stride;
+    bool *confirmed;
+} StrideState;
+
+static void strideObserve ( Prefetcher* prefetcher, int slot, int page ) {
+    StrideState* s = (StrideState*) prefetcher->state;
+    int stride = page - s->last[slot];
+
+    s->confirmed[slot] = s->last[slot] >= 0 && stride != 0 && stride == s->stride[slot];
+    s->stride[slot] = ( s->last[slot] >= 0 ) ? stride : 0;
+    s->last[slot] = page;
+}
+
+static int stridePredict ( Prefetcher* prefetcher, int slot, int page, int* pages ) {
+    StrideState* s = (StrideState*) prefetcher->state;
+    int count = 0;
+
+    if ( !s->confirmed[slot] ) {
+        return 0;
+    }
+
+    while ( count < prefetcher->depth && ( page += s->stride[slot] ) >= 0 && page < prefetcher->pages ) {
+        pages[count++] = page;
+    }
+    return count;
+}
+
+// Sequential read-ahead only looks for a stride of one page forward, and starts after the first one.
+static int sequentialPredict ( Prefetcher* prefetcher, int slot, int page, int* pages ) {
+    StrideState* s = (StrideState*) prefetcher->state;
+    int count = 0;
+
+    if ( s->stride[slot] != 1 ) {
+        return 0;
+    }
+
+    while ( count < prefetcher->depth && ++page < prefetcher->pages ) {
+        pages[count++] = page;
+    }
+    return count;
+}
+
+static void strideReset ( Prefetcher* prefetcher, int slot ) {
+    StrideState* s = (StrideState*) prefetcher->state;
+
+    s->last[slot] = -1;
+    s->stride[slot] = 0;
+    s->confirmed[slot] = false;
+}
+
+static void strideDestroy ( Prefetcher* prefetcher ) {
+    StrideState* s = (StrideState*) prefetcher->state;
+
+    free ( s->last );
+    free ( s->stride );
+    free ( s->confirmed );
+    free ( s );
+}
+
+static bool strideCreate ( Prefetcher* prefetcher ) {
+    StrideState* s = (StrideState*) calloc ( 1, sizeof ( StrideState ) );
+    int i;
+
+    s->last = (int*) malloc ( prefetcher->slots * sizeof ( int ) );
+    s->stride = (int*) malloc ( prefetcher->slots * sizeof ( int ) );
+    s->confirmed = (bool*) malloc ( prefetcher->slots * sizeof ( bool ) );
+    prefetcher->state = s;
+    prefetcher->observe = strideObserve;
+    prefetcher->predict = stridePredict;
+    prefetcher->reset = strideReset;
+    prefetcher->destroy = strideDestroy;
+    if ( s->last == NULL || s->stride == NULL || s->confirmed == NULL ) {
+        return false;
+    }
+
+    for ( i = 0; i < prefetcher->slots; ++i ) {
+        strideReset ( prefetcher, i );
+    }
+    return true;
+}
+
+static bool sequentialCreate ( Prefetcher* prefetcher ) {
+    bool created = strideCreate ( prefetcher );
+
+    prefetcher->predict = sequentialPredict;
+    return created;
+}
+
+
+/* Markov */
+// For each slot, the last page it referenced, and for each of its pages the page it was last followed by
+//  (-1 if none yet). Predictions follow that chain from the faulting page.
+typedef struct {
+    int *last;
+    int *next;                  // slots * pages entries.
+} MarkovState;
+
+static void markovObserve ( Prefetcher* prefetcher, int slot, int page ) {
+    MarkovState* s = (MarkovState*) prefetcher->state;
+
+    if ( s->last[slot] >= 0 && s->last[slot] != page ) {
+        s->next[(long) slot * prefetcher->pages + s->last[slot]] = page;
+    }
+    s->last[slot] = page;
+}
+
+static int markovPredict ( Prefetcher* prefetcher, int slot, int page, int* pages ) {
+    MarkovState* s = (MarkovState*) prefetcher->state;
+    int* next = s->next + (long) slot * prefetcher->pages;
+    int count = 0, i, step = next[page];
+
+    // Stop at the end of what is known, or when the chain loops back on itself.
+    while ( count < prefetcher->depth && step >= 0 && step != page ) {
+        for ( i = 0; i < count && pages[i] != step; ++i ) {
+        }
+        if ( i < count ) {
+            break;
+        }
+        pages[count++] = step;
+        step = next[step];
+    }
+    return count;
+}
+
+static void markovReset ( Prefetcher* prefetcher, int slot ) {
+    MarkovState* s = (MarkovState*) prefetcher->state;
+
+    s->last[slot] = -1;
+    memset ( s->next + (long) slot * prefetcher->pages, 0xff, prefetcher->pages * sizeof ( int ) );
+}
+
+static void markovDestroy ( Prefetcher* prefetcher ) {
+    MarkovState* s = (MarkovState*) prefetcher->state;
+
+    free ( s->last );
+    free ( s->next );
+    free ( s );
+}
+
+static bool markovCreate ( Prefetcher* prefetcher ) {
+    MarkovState* s = (MarkovState*) calloc ( 1, sizeof ( MarkovState ) );
+    int i;
+
+    s->last = (int*) malloc ( prefetcher->slots * sizeof ( int ) );
+    s->next = (int*) malloc ( (size_t) prefetcher->slots * prefetcher->pages * sizeof ( int ) );
+    prefetcher->state = s;
+    prefetcher->observe = markovObserve;
+    prefetcher->predict = markovPredict;
+    prefetcher->reset = markovReset;
+    prefetcher->destroy = markovDestroy;
+    if ( s->last == NULL || s->next == NULL ) {
+        return false;
+    }
+
+    for ( i = 0; i < prefetcher->slots; ++i ) {
+        markovReset ( prefetcher, i );
+    }
+    return true;
+}
+
+
+/* Function Definitions */
+
+// Table of the available prefetchers.
+static const struct {
+    const char *name;
+    bool ( *create ) ( Prefetcher* prefetcher );
+} prefetcherTable[] = {
+    { "seq", sequentialCreate },
+    { "stride", strideCreate },
+    { "markov", markovCreate },
+};
+
+#define NUMBER_OF_PREFETCHERS ( sizeof ( prefetcherTable ) / sizeof ( prefetcherTable[0] ) )
+
+// Function to create the prefetcher described by spec (name[:depth]) for slots PCB slots of pages pages each.
+//  Returns NULL if there is no prefetcher by that name, the depth is out of range or its tables can't be
+//  allocated. "none" is not a prefetcher, see prefetcherWanted.
+Prefetcher* createPrefetcher ( const char* spec, int slots, int pages ) {
+    const char* arguments = strchr ( spec, ':' );
+    size_t nameLength = arguments != NULL ? (size_t) ( arguments - spec ) : strlen ( spec );
+    unsigned int i;
+    Prefetcher* prefetcher;
+
+    for ( i = 0; i < NUMBER_OF_PREFETCHERS; ++i ) {
+        if ( nameLength == strlen ( prefetcherTable[i].name ) && strncmp ( spec, prefetcherTable[i].name, nameLength ) == 0 ) {
+            prefetcher = (Prefetcher*) calloc ( 1, sizeof ( Prefetcher ) );
+            prefetcher->name = prefetcherTable[i].name;
+            prefetcher->depth = ( arguments != NULL ) ? atoi ( arguments + 1 ) : DEFAULT_PREFETCH_DEPTH;
+            prefetcher->slots = slots;
+            prefetcher->pages = pages;
+            if ( prefetcher->depth < 1 || prefetcher->depth > MAX_PREFETCH ) {
+                free ( prefetcher );
+                return NULL;
+            }
+            if ( !prefetcherTable[i].create ( prefetcher ) ) {
+                destroyPrefetcher ( prefetcher );
+                return NULL;
+            }
+            return prefetcher;
+        }
+    }
+
+    return NULL;
+}
+
+void destroyPrefetcher ( Prefetcher* prefetcher ) {
+    prefetcher->destroy ( prefetcher );
+    free ( prefetcher );
+}
+
+// Function to tell if spec asks for a prefetcher at all.
+bool prefetcherWanted ( const char* spec ) {
+    return spec != NULL && strcmp ( spec, "none" ) != 0;
+}
+
+// Function to get the names of every prefetcher for help messages.
+const char* prefetcherNames() {
+    return "none, seq[:n], stride[:n], markov[:n]";
+}
@@ -0,0 +1,63 @@
+// File name: prefetch.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the prefetchers used by pager.c. On a page fault the pager asks its prefetcher
+//  which other pages of the faulting process it is likely to want next, and reads them in along
+//  with the faulting page. OSS picks one with -a:
+//
+//  none        No read-ahead (the default).
+//  seq[:n]     Once a process references two pages in a row, read the n pages after the second.
+//  stride[:n]  Once two references in a row are the same number of pages apart, read the next n
+//              pages at that distance.
+//  markov[:n]  Remember which page each page was followed by, per process, and read along that
+//              chain for up to n pages.
+//
+// n is the most pages read ahead per fault, default 4, up to MAX_PREFETCH. A prefetcher learns from
+//  the references that would have faulted without it: page faults, and the first reference to a
+//  page it read ahead.
+
+#ifndef prefetch_h
+#define prefetch_h
+
+#include <stdbool.h>
+
+
+/* Constants */
+#define MAX_PREFETCH 16
+#define DEFAULT_PREFETCH_DEPTH 4
+
+
+/* Structures */
+// A prefetcher. Slots are the pager's PCB slots (local indexes in a shard), pages the page numbers
+//  of a process.
+typedef struct Prefetcher Prefetcher;
+struct Prefetcher {
+    const char *name;
+    int depth;                  // Most pages predicted per fault.
+    int slots;
+    int pages;
+    void *state;
+
+    // The process in slot referenced page, which either faulted or had been read ahead.
+    void ( *observe ) ( Prefetcher* prefetcher, int slot, int page );
+
+    // Predict the pages the process in slot wants after faulting on page (already observed). Writes up to
+    //  depth page numbers to pages and returns how many.
+    int ( *predict ) ( Prefetcher* prefetcher, int slot, int page, int* pages );
+
+    // The process in slot terminated. Forget what was learned about it.
+    void ( *reset ) ( Prefetcher* prefetcher, int slot );
+
+    void ( *destroy ) ( Prefetcher* prefetcher );
+};
+
+
+/* Function Prototypes */
+Prefetcher* createPrefetcher ( const char* spec, int slots, int pages );
+void destroyPrefetcher ( Prefetcher* prefetcher );
+bool prefetcherWanted ( const char* spec );
+const char* prefetcherNames ( void );
+
+#endif
@@ -0,0 +1,225 @@
+// File name: ring.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Shared-memory ring transport between OSS and USER. See ring.h for the layout.
+//
+// Each ring has exactly one producer and one consumer, so pushing and popping only
+//  needs an acquire/release pair on head and tail. A process only goes into the kernel
+//  (futex) when it has nothing to do: USER while waiting for its response, OSS while
+//  every request ring is empty.
+
+#include "ring.h"
+
+#include <string.h>
+#include <limits.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+
+/* Futex helpers */
+// The segment is shared between processes, so the non-private futex operations are used.
+static void futexWait ( unsigned int* word, unsigned int expected ) {
+    syscall ( SYS_futex, word, FUTEX_WAIT, expected, NULL, NULL, 0 );
+}
+
+static void futexWake ( unsigned int* word ) {
+    syscall ( SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0 );
+}
+
+
+/* Function Definitions */
+
+// Function to get the number of bytes needed for a ring segment with the given number of PCB slots.
+size_t ringSetSize ( int numberOfSlots ) {
+    return sizeof ( RingSet ) + ( 2 * numberOfSlots * sizeof ( Ring ) );
+}
+
+// Function to reset every ring in a freshly created segment.
+void ringSetInit ( RingSet* set, int numberOfSlots, int numberOfShards ) {
+    int i;
+
+    memset ( set, 0, ringSetSize ( numberOfSlots ) );
+    set->numberOfSlots = numberOfSlots;
+    set->numberOfShards = numberOfShards;
+    for ( i = 0; i < numberOfShards; ++i ) {
+        set->doorbells[i].nextIndex = i;
+    }
+}
+
+// Function to tell every USER that OSS is done. Wakes anyone sleeping on a response ring.
+void ringSetShutdown ( RingSet* set ) {
+    int i;
+
+    __atomic_store_n ( &set->shutdown, 1, __ATOMIC_SEQ_CST );
+    for ( i = 0; i < set->numberOfSlots; ++i ) {
+        Ring* ring = &set->rings[2 * i + 1];
+        // Moving head makes a USER that is just about to sleep return from the futex right away.
+        //  It checks shutdown before popping, so the bogus slot is never read.
+        __atomic_add_fetch ( &ring->head, 1, __ATOMIC_SEQ_CST );
+        futexWake ( &ring->head );
+    }
+}
+
+// Function to get the number of slots an item of the given size takes up.
+static unsigned int slotsFor ( size_t size ) {
+    return ( size + RING_SLOT_BYTES - 1 ) / RING_SLOT_BYTES;
+}
+
+// Function to add an item to a ring. Returns false if there isn't room for all of it. head is
+//  only moved once the whole item is copied, so the consumer never sees part of one. head is
+//  loaded with acquire since OSS worker threads take turns producing on a response ring.
+bool ringPush ( Ring* ring, const void* item, size_t size ) {
+    unsigned int head = __atomic_load_n ( &ring->head, __ATOMIC_ACQUIRE );
+    unsigned int tail = __atomic_load_n ( &ring->tail, __ATOMIC_ACQUIRE );
+    unsigned int slots = slotsFor ( size );
+    unsigned int i;
+    size_t chunk;
+
+    if ( RING_CAPACITY - ( head - tail ) < slots ) {
+        return false;
+    }
+
+    for ( i = 0; i < slots; ++i ) {
+        chunk = ( size > RING_SLOT_BYTES ) ? RING_SLOT_BYTES : size;
+        memcpy ( ring->slots[( head + i ) & ( RING_CAPACITY - 1 )], (const unsigned char*) item + i * RING_SLOT_BYTES, chunk );
+        size -= chunk;
+    }
+    __atomic_store_n ( &ring->head, head + slots, __ATOMIC_RELEASE );
+
+    return true;
+}
+
+// Function to remove an item from a ring. Returns false if the ring doesn't hold a whole item.
+bool ringPop ( Ring* ring, void* item, size_t size ) {
+    unsigned int tail = ring->tail;
+    unsigned int head = __atomic_load_n ( &ring->head, __ATOMIC_ACQUIRE );
+    unsigned int slots = slotsFor ( size );
+    unsigned int i;
+    size_t chunk;
+
+    if ( head - tail < slots ) {
+        return false;
+    }
+
+    for ( i = 0; i < slots; ++i ) {
+        chunk = ( size > RING_SLOT_BYTES ) ? RING_SLOT_BYTES : size;
+        memcpy ( (unsigned char*) item + i * RING_SLOT_BYTES, ring->slots[( tail + i ) & ( RING_CAPACITY - 1 )], chunk );
+        size -= chunk;
+    }
+    __atomic_store_n ( &ring->tail, tail + slots, __ATOMIC_RELEASE );
+
+    return true;
+}
+
+// Function to ring a shard's doorbell.
+static void ringWakeShard ( RingSet* set, int shard ) {
+    RingDoorbell* bell = &set->doorbells[shard];
+
+    __atomic_add_fetch ( &bell->doorbell, 1, __ATOMIC_SEQ_CST );
+    if ( __atomic_load_n ( &bell->ossWaiting, __ATOMIC_SEQ_CST ) ) {
+        futexWake ( &bell->doorbell );
+    }
+}
+
+// Function used by USER to send a request to OSS. Rings its shard's doorbell and only makes
+//  the wake-up syscall if OSS is actually asleep.
+void ringSendRequest ( RingSet* set, int index, const void* item, size_t size ) {
+    Ring* ring = &set->rings[2 * index];
+
+    while ( !ringPush ( ring, item, size ) ) {
+        sched_yield();
+    }
+
+    ringWakeShard ( set, index % set->numberOfShards );
+}
+
+// Function used by OSS to stop receiving on a shard. Wakes the worker if it is asleep on the doorbell.
+void ringCloseShard ( RingSet* set, int shard ) {
+    __atomic_store_n ( &set->doorbells[shard].closed, 1, __ATOMIC_SEQ_CST );
+    ringWakeShard ( set, shard );
+}
+
+// Function to pop one request from a shard's request rings (slots shard, shard + shards, ...),
+//  starting where the last scan left off. Returns the PCB index or -1 if they are all empty.
+static int ringScanShard ( RingSet* set, int shard, void* item, size_t size ) {
+    RingDoorbell* doorbell = &set->doorbells[shard];
+    int stride = set->numberOfShards;
+    int index = doorbell->nextIndex;
+    int i;
+
+    for ( i = shard; i < set->numberOfSlots; i += stride ) {
+        if ( ringPop ( &set->rings[2 * index], item, size ) ) {
+            doorbell->nextIndex = ( index + stride < set->numberOfSlots ) ? index + stride : shard;
+            return index;
+        }
+        index = ( index + stride < set->numberOfSlots ) ? index + stride : shard;
+    }
+    return -1;
+}
+
+// Function used by OSS to receive the next request from any USER in a shard. The shard's
+//  request rings are scanned round-robin so no PCB slot can starve the others. Blocks on the
+//  shard's doorbell when every ring is empty. Returns the PCB index the request came from, or
+//  -1 if the doorbell was rung with nothing to receive or the shard was closed (see ringCloseShard).
+int ringReceiveRequest ( RingSet* set, int shard, void* item, size_t size ) {
+    RingDoorbell* doorbell = &set->doorbells[shard];
+    unsigned int bell;
+    int index;
+
+    bell = __atomic_load_n ( &doorbell->doorbell, __ATOMIC_SEQ_CST );
+    if ( ( index = ringScanShard ( set, shard, item, size ) ) >= 0 ) {
+        return index;
+    }
+    if ( __atomic_load_n ( &doorbell->closed, __ATOMIC_SEQ_CST ) ) {
+        return -1;
+    }
+
+    // Nothing found. Sleep unless a request arrived while the rings were being scanned.
+    __atomic_store_n ( &doorbell->ossWaiting, 1, __ATOMIC_SEQ_CST );
+    if ( __atomic_load_n ( &doorbell->doorbell, __ATOMIC_SEQ_CST ) == bell ) {
+        futexWait ( &doorbell->doorbell, bell );
+    }
+    __atomic_store_n ( &doorbell->ossWaiting, 0, __ATOMIC_SEQ_CST );
+
+    return ringScanShard ( set, shard, item, size );
+}
+
+// Function used by OSS to send a response to the USER at the given PCB index.
+void ringSendResponse ( RingSet* set, int index, const void* item, size_t size ) {
+    Ring* ring = &set->rings[2 * index + 1];
+
+    while ( !ringPush ( ring, item, size ) ) {
+        sched_yield();
+    }
+
+    if ( __atomic_load_n ( &ring->consumerWaiting, __ATOMIC_SEQ_CST ) ) {
+        futexWake ( &ring->head );
+    }
+}
+
+// Function used by USER to wait for its response from OSS. Returns false if OSS shut down
+//  the transport instead of answering.
+bool ringReceiveResponse ( RingSet* set, int index, void* item, size_t size ) {
+    Ring* ring = &set->rings[2 * index + 1];
+    unsigned int head;
+
+    while ( 1 ) {
+        if ( __atomic_load_n ( &set->shutdown, __ATOMIC_SEQ_CST ) ) {
+            return false;
+        }
+        if ( ringPop ( ring, item, size ) ) {
+            return true;
+        }
+
+        // Ring is empty. Sleep until OSS moves head.
+        __atomic_store_n ( &ring->consumerWaiting, 1, __ATOMIC_SEQ_CST );
+        head = __atomic_load_n ( &ring->head, __ATOMIC_SEQ_CST );
+        if ( head == ring->tail && !__atomic_load_n ( &set->shutdown, __ATOMIC_SEQ_CST ) ) {
+            futexWait ( &ring->head, head );
+        }
+        __atomic_store_n ( &ring->consumerWaiting, 0, __ATOMIC_SEQ_CST );
+    }
+}
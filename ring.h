@@ -0,0 +1,75 @@
+// File name: ring.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the shared-memory ring transport used by oss.c and user.c.
+//  When oss is run with -r, every PCB slot gets a request ring and a response
+//  ring in a shared memory segment and the message queue is not used. With worker
+//  threads (oss -w) the PCB slots are split into shards and each shard has its own
+//  doorbell, so a worker only wakes up for its own slots.
+
+#ifndef ring_h
+#define ring_h
+
+#include <stddef.h>
+#include <stdbool.h>
+
+
+/* Constants */
+#define RING_CAPACITY 128       // Number of slots in each ring. Must be a power of two.
+#define RING_SLOT_BYTES 64      // Size of each slot. Large enough to hold one Message. Bigger items
+                                //  (batches) take up as many consecutive slots as they need.
+#define CACHE_LINE 64
+#define RING_MAX_SHARDS 64
+
+
+/* Structures */
+// Single-producer/single-consumer ring. The producer only writes head and the consumer only
+//  writes tail. Each index sits on its own cache line so the two sides don't fight over it.
+typedef struct {
+    unsigned int head;                      // Next slot the producer will fill. Also used as the futex word.
+    char headPad[CACHE_LINE - sizeof ( unsigned int )];
+    unsigned int tail;                      // Next slot the consumer will empty.
+    char tailPad[CACHE_LINE - sizeof ( unsigned int )];
+    unsigned int consumerWaiting;           // Set by the consumer right before it sleeps on an empty ring.
+    char waitPad[CACHE_LINE - sizeof ( unsigned int )];
+    unsigned char slots[RING_CAPACITY][RING_SLOT_BYTES];
+} Ring;
+
+// Doorbell for one shard of PCB slots (slot i belongs to shard i % numberOfShards).
+typedef struct {
+    unsigned int doorbell;                  // Bumped on every request so OSS can sleep on all of the shard's request rings at once.
+    unsigned int ossWaiting;                // Set by OSS right before it sleeps on the doorbell.
+    int nextIndex;                          // Slot the next scan starts at. Only used by OSS.
+    unsigned int closed;                    // Set by OSS to stop the worker receiving on the shard.
+    char pad[CACHE_LINE - 4 * sizeof ( int )];
+} RingDoorbell;
+
+// Header of the shared memory segment. The rings follow it: ring 2i is the request ring for
+//  PCB index i and ring 2i+1 is its response ring.
+typedef struct {
+    unsigned int shutdown;                  // Set by OSS when it is done so sleeping USERs can exit.
+    int numberOfSlots;                      // Number of PCB slots (and ring pairs) in the segment.
+    int numberOfShards;
+    char pad[CACHE_LINE - 3 * sizeof ( int )];
+    RingDoorbell doorbells[RING_MAX_SHARDS];
+    Ring rings[];
+} RingSet;
+
+
+/* Function Prototypes */
+size_t ringSetSize ( int numberOfSlots );
+void ringSetInit ( RingSet* set, int numberOfSlots, int numberOfShards );
+void ringSetShutdown ( RingSet* set );
+
+bool ringPush ( Ring* ring, const void* item, size_t size );
+bool ringPop ( Ring* ring, void* item, size_t size );
+
+void ringSendRequest ( RingSet* set, int index, const void* item, size_t size );
+int ringReceiveRequest ( RingSet* set, int shard, void* item, size_t size );
+void ringCloseShard ( RingSet* set, int shard );
+void ringSendResponse ( RingSet* set, int index, const void* item, size_t size );
+bool ringReceiveResponse ( RingSet* set, int index, void* item, size_t size );
+
+#endif
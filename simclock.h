@@ -0,0 +1,63 @@
+// File name: simclock.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the simulated clock OSS keeps in shared memory. The time is one 64-bit
+//  count of nanoseconds, so a read is a single load that can never see half of an update,
+//  and an advance is a single atomic add with no carry from nanoseconds into seconds. It has
+//  a cache line to itself. Seconds and nanoseconds are only split apart for display.
+
+#ifndef simclock_h
+#define simclock_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/* Constants */
+#define NANOSECONDS_PER_SECOND 1000000000ULL
+
+
+/* Structures */
+typedef struct {
+    uint64_t nanoseconds;
+    char pad[64 - sizeof ( uint64_t )];
+} __attribute__ ( ( aligned ( 64 ) ) ) SimClock;
+
+
+/* Function Definitions */
+
+// Function to read the clock.
+static inline uint64_t clockNow ( const SimClock* clock ) {
+    return __atomic_load_n ( &clock->nanoseconds, __ATOMIC_ACQUIRE );
+}
+
+// Function to set the clock. Only used before anyone else is reading it.
+static inline void clockSet ( SimClock* clock, uint64_t time ) {
+    __atomic_store_n ( &clock->nanoseconds, time, __ATOMIC_RELEASE );
+}
+
+// Function to move the clock forward by some amount of time.
+static inline void clockAdvance ( SimClock* clock, uint64_t nanoseconds ) {
+    __atomic_add_fetch ( &clock->nanoseconds, nanoseconds, __ATOMIC_ACQ_REL );
+}
+
+// Function to move the clock forward to a time, unless it is already past it.
+static inline void clockAdvanceTo ( SimClock* clock, uint64_t time ) {
+    uint64_t now = __atomic_load_n ( &clock->nanoseconds, __ATOMIC_ACQUIRE );
+
+    while ( now < time && !__atomic_compare_exchange_n ( &clock->nanoseconds, &now, time, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) ) {
+    }
+}
+
+// Functions to split a time into seconds and nanoseconds for display.
+static inline unsigned int clockSeconds ( uint64_t time ) {
+    return (unsigned int) ( time / NANOSECONDS_PER_SECOND );
+}
+
+static inline unsigned int clockNanoseconds ( uint64_t time ) {
+    return (unsigned int) ( time % NANOSECONDS_PER_SECOND );
+}
+
+#endif
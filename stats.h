@@ -0,0 +1,96 @@
+// File name: stats.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the live statistics segment. OSS creates it next to the simulated clock and
+//  publishes its counters there while it runs; ./ossstat attaches read-only and prints them.
+//  Every counter has one writer (a shard's pager, or whoever holds ossLock) and is written with
+//  a relaxed atomic store of the value it already keeps, so publishing costs a few plain stores
+//  on a cache line the writer owns. Readers see each counter whole but not a consistent
+//  snapshot across counters, which is fine for watching a run.
+
+#ifndef stats_h
+#define stats_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+
+/* Constants */
+#define STATS_MAGIC 0x5354534fU         // "OSTS"
+#define STATS_VERSION 4
+#define STATS_MAX_SHARDS 64             // Same as RING_MAX_SHARDS, the most worker threads.
+
+
+/* Structures */
+// Counters of one pager shard, on their own cache line.
+typedef struct {
+    unsigned long references;
+    unsigned long faults;
+    unsigned long evictions;
+    long freeFrames;
+    long residentFrames;
+    long dirtyFrames;
+} __attribute__ ( ( aligned ( 64 ) ) ) ShardStats;
+
+typedef struct {
+    // Set once before the run starts.
+    uint32_t magic;
+    uint32_t version;
+    pid_t ossPid;
+    int slots;                          // PCB slots, the length of residentPages.
+    int frames;
+    int shardCount;                     // Pager shards (worker threads) with counters in shards.
+    int pagesPerProcess;
+    int maxProcesses;                   // Processes the run creates in total.
+    int workingSetWindow;               // References per working set window.
+    int admissionControl;               // 1 if process creation waits for the working sets to fit (oss -A).
+    int cleanerBatch;                   // Most pages the page cleaner writes back at once, 0 if it is off (oss -C).
+    char policy[128];                   // As long as oss's -p list, so it is never cut short.
+    char workload[48];
+    char mode[16];                      // Transport, as in the report. ossstat adds the options below to it.
+    int workers;                        // oss -w.
+    int batchSize;                      // oss -b.
+    int poolMode;                       // 1 with a pre-forked USER pool (oss -F).
+
+    // Written under ossLock.
+    int running __attribute__ ( ( aligned ( 64 ) ) );       // 1 while OSS serves requests, 0 once it is done.
+    long activeProcesses;
+    long processesCreated;
+    long diskWaiting;
+    unsigned long writebacks;           // Dirty pages written back when their frame was taken.
+    unsigned long cleanedPages;         // Dirty pages written back ahead of time by the page cleaner.
+    long workingSetTotal;               // Summed working sets of the active processes when one was last created.
+    long deferredSpawns;                // Process creations held back by admission control.
+
+    ShardStats shards[STATS_MAX_SHARDS];
+
+    // Per PCB slot, slots entries each: pages loaded, written by the pager that owns the slot (or is evicting
+    //  from it) under its lock, then the working set from the last sample (see statsResidentPages and
+    //  statsWorkingSets).
+    int slotPages[];
+} StatsSegment;
+
+
+/* Function Definitions */
+
+// Function to get the size of a segment with room for slots PCB slots.
+static inline size_t statsSegmentSize ( int slots ) {
+    return sizeof ( StatsSegment ) + 2 * slots * sizeof ( int );
+}
+
+static inline int* statsResidentPages ( StatsSegment* stats ) {
+    return stats->slotPages;
+}
+
+static inline int* statsWorkingSets ( StatsSegment* stats ) {
+    return stats->slotPages + stats->slots;
+}
+
+// Function to publish a counter. Counters only ever have one writer.
+#define statsStore(field, value) __atomic_store_n ( &( field ), ( value ), __ATOMIC_RELAXED )
+#define statsLoad(field) __atomic_load_n ( &( field ), __ATOMIC_RELAXED )
+
+#endif
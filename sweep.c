@@ -0,0 +1,293 @@
+// File name: sweep.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Policy sweep over a mapped trace. See sweep.h.
+//
+// Each (size, policy) pair is a job with its own pager. One more job works out the LRU stack
+//  distance of every reference (Mattson et al.): the page's depth in a stack ordered by last use.
+//  LRU with C frames has the page loaded exactly when the distance is at most C, so one pass over
+//  the trace gives exact LRU for every size. The jobs are handed out to a pool of one thread per CPU.
+//
+// When a process terminates its frames are freed, so its pages can't just be taken off the stack
+//  (that would pull pages LRU had already replaced back into the top C). They stay as holes, which
+//  stand for free frames: a page fault uses the hole nearest the top instead of pushing everything
+//  down, and on a hit the hole nearest the top above the page sinks to where the page was.
+
+#include "sweep.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+
+/* Thread pool */
+typedef struct {
+    Sweep *sweep;
+    const TraceMap *trace;
+    pthread_mutex_t lock;
+    int nextJob;
+    int jobCount;
+} SweepPool;
+
+
+/* Stack distances */
+// Max-heap of the stack positions (last use times) of the holes.
+typedef struct {
+    long *slots;
+    long count;
+    long capacity;
+} HoleHeap;
+
+static void holePush ( HoleHeap* heap, long position ) {
+    long i, parent;
+
+    if ( heap->count == heap->capacity ) {
+        heap->capacity = heap->capacity ? heap->capacity * 2 : 256;
+        heap->slots = (long*) realloc ( heap->slots, heap->capacity * sizeof ( long ) );
+    }
+
+    for ( i = heap->count++; i > 0 && heap->slots[parent = ( i - 1 ) / 2] < position; i = parent ) {
+        heap->slots[i] = heap->slots[parent];
+    }
+    heap->slots[i] = position;
+}
+
+static long holePop ( HoleHeap* heap ) {
+    long top = heap->slots[0];
+    long last = heap->slots[--heap->count];
+    long i = 0, child;
+
+    while ( ( child = 2 * i + 1 ) < heap->count ) {
+        if ( child + 1 < heap->count && heap->slots[child + 1] > heap->slots[child] ) {
+            child++;
+        }
+        if ( heap->slots[child] <= last ) {
+            break;
+        }
+        heap->slots[i] = heap->slots[child];
+        i = child;
+    }
+    heap->slots[i] = last;
+
+    return top;
+}
+
+// Function to add delta at position i of a Fenwick tree (1-based).
+static void fenwickAdd ( int* tree, long size, long i, int delta ) {
+    for ( ; i <= size; i += i & -i ) {
+        tree[i] += delta;
+    }
+}
+
+// Function to sum positions 1 to i of a Fenwick tree.
+static long fenwickSum ( const int* tree, long i ) {
+    long sum = 0;
+
+    for ( ; i > 0; i -= i & -i ) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+// Function to fill in exactFaults for every size in one pass. Stack entries (pages and holes) are
+//  kept as 1s in a Fenwick tree at the time of their last use, so the stack distance of a reference
+//  is the number of 1s after the last use of its page. Distances past the largest size are all
+//  counted as misses.
+static void stackDistances ( Sweep* sweep, const TraceMap* trace ) {
+    long size = trace->recordCount;
+    long pages = (long) sweep->config.processes * sweep->config.pagesPerProcess;
+    long maxDistance = 0;
+    int* tree = (int*) calloc ( size + 1, sizeof ( int ) );
+    long* lastUse = (long*) calloc ( pages, sizeof ( long ) );
+    long* histogram;
+    HoleHeap holes = { NULL, 0, 0 };
+    long references = 0, coldMisses = 0, distance, i, page;
+    int s, p;
+
+    for ( s = 0; s < sweep->sizeCount; ++s ) {
+        if ( sweep->sizes[s] > maxDistance ) {
+            maxDistance = sweep->sizes[s];
+        }
+    }
+    histogram = (long*) calloc ( maxDistance + 2, sizeof ( long ) );
+
+    for ( i = 1; i <= size; ++i ) {
+        const TraceRecord* record = &trace->records[i - 1];
+        long* last = &lastUse[(long) record->blockIndex * sweep->config.pagesPerProcess];
+
+        if ( record->flags & TRACE_TERMINATE ) {
+            for ( p = 0; p < sweep->config.pagesPerProcess; ++p ) {
+                if ( last[p] != 0 ) {
+                    holePush ( &holes, last[p] );
+                    last[p] = 0;
+                }
+            }
+            continue;
+        }
+
+        references++;
+        page = record->pageRef;
+        if ( last[page] == 0 ) {
+            // Miss at every size. The top hole (if any) is the free frame it goes into.
+            coldMisses++;
+            if ( holes.count > 0 ) {
+                fenwickAdd ( tree, size, holePop ( &holes ), -1 );
+            }
+        } else {
+            distance = fenwickSum ( tree, i ) - fenwickSum ( tree, last[page] ) + 1;
+            histogram[distance > maxDistance ? maxDistance + 1 : distance]++;
+
+            // The top hole above the page takes the page's place. Otherwise the page's place is emptied.
+            if ( holes.count > 0 && holes.slots[0] > last[page] ) {
+                fenwickAdd ( tree, size, holePop ( &holes ), -1 );
+                holePush ( &holes, last[page] );
+            } else {
+                fenwickAdd ( tree, size, last[page], -1 );
+            }
+        }
+        fenwickAdd ( tree, size, i, 1 );
+        last[page] = i;
+    }
+
+    sweep->references = references;
+
+    // Faults with C frames are the cold misses plus every reference with a distance over C.
+    for ( s = 0; s < sweep->sizeCount; ++s ) {
+        sweep->exactFaults[s] = coldMisses;
+        for ( distance = sweep->sizes[s] + 1; distance <= maxDistance + 1; ++distance ) {
+            sweep->exactFaults[s] += histogram[distance];
+        }
+    }
+
+    free ( tree );
+    free ( lastUse );
+    free ( histogram );
+    free ( holes.slots );
+}
+
+
+/* Simulation */
+// Function to run one (size, policy) job. Job 0 is the stack distance pass.
+static void runJob ( SweepPool* pool, int job ) {
+    Sweep* sweep = pool->sweep;
+    const TraceRecord* record = pool->trace->records;
+    const TraceRecord* end = record + pool->trace->recordCount;
+    PagerConfig config = sweep->config;
+    PagerResult result;
+    Pager* pager;
+    int s, p;
+
+    if ( job == 0 ) {
+        stackDistances ( sweep, pool->trace );
+        return;
+    }
+
+    s = ( job - 1 ) / sweep->policyCount;
+    p = ( job - 1 ) % sweep->policyCount;
+    config.frames = sweep->sizes[s];
+    config.policy = sweep->policies[p];
+    pager = createPager ( &config );
+
+    for ( ; record < end; ++record ) {
+        if ( record->flags & TRACE_TERMINATE ) {
+            pagerRelease ( pager, record->blockIndex );
+        } else {
+            pagerReference ( pager, record->pid, record->blockIndex, record->pageRef, ( record->flags & TRACE_WRITE ) != 0, &result );
+        }
+    }
+
+    sweep->faults[s][p] = pager->faults;
+    destroyPager ( pager );
+}
+
+// Function run by each thread in the pool. Takes jobs until there are none left.
+static void* sweepWorker ( void* arg ) {
+    SweepPool* pool = (SweepPool*) arg;
+    int job;
+
+    for ( ;; ) {
+        pthread_mutex_lock ( &pool->lock );
+        job = pool->nextJob++;
+        pthread_mutex_unlock ( &pool->lock );
+
+        if ( job >= pool->jobCount ) {
+            return NULL;
+        }
+        runJob ( pool, job );
+    }
+}
+
+
+/* Function Definitions */
+
+// Function to run every job in the sweep. Returns false if one of the policies or the page table
+//  backend doesn't exist.
+bool runSweep ( Sweep* sweep, const TraceMap* trace ) {
+    pthread_t threads[64];
+    struct timespec start, finish;
+    PagerConfig config = sweep->config;
+    SweepPool pool;
+    Pager* check;
+    long cpus;
+    int numberOfThreads, i;
+
+    for ( i = 0; i < sweep->policyCount; ++i ) {
+        config.frames = sweep->sizes[0];
+        config.policy = sweep->policies[i];
+        if ( ( check = createPager ( &config ) ) == NULL ) {
+            return false;
+        }
+        destroyPager ( check );
+    }
+
+    pool.sweep = sweep;
+    pool.trace = trace;
+    pool.nextJob = 0;
+    pool.jobCount = 1 + sweep->sizeCount * sweep->policyCount;
+    pthread_mutex_init ( &pool.lock, NULL );
+
+    // One thread per CPU, but never more threads than jobs.
+    cpus = sysconf ( _SC_NPROCESSORS_ONLN );
+    numberOfThreads = cpus < 1 ? 1 : cpus > 64 ? 64 : cpus;
+    if ( numberOfThreads > pool.jobCount ) {
+        numberOfThreads = pool.jobCount;
+    }
+
+    clock_gettime ( CLOCK_MONOTONIC, &start );
+    for ( i = 0; i < numberOfThreads; ++i ) {
+        pthread_create ( &threads[i], NULL, sweepWorker, &pool );
+    }
+    for ( i = 0; i < numberOfThreads; ++i ) {
+        pthread_join ( threads[i], NULL );
+    }
+    clock_gettime ( CLOCK_MONOTONIC, &finish );
+
+    sweep->seconds = ( finish.tv_sec - start.tv_sec ) + ( finish.tv_nsec - start.tv_nsec ) / 1e9;
+    pthread_mutex_destroy ( &pool.lock );
+
+    return true;
+}
+
+// Function to print the fault rate table: one row per size, one column per policy, then exact LRU.
+void printSweep ( const Sweep* sweep, FILE* out ) {
+    double references = sweep->references > 0 ? sweep->references : 1;
+    int s, p;
+
+    fprintf ( out, "Page faults per access over %ld references (%d simulations in %.3f seconds):\n", sweep->references, sweep->sizeCount * sweep->policyCount + 1, sweep->seconds );
+    fprintf ( out, "%8s", "frames" );
+    for ( p = 0; p < sweep->policyCount; ++p ) {
+        fprintf ( out, " %9s", sweep->policies[p] );
+    }
+    fprintf ( out, " %9s\n", "lru-exact" );
+
+    for ( s = 0; s < sweep->sizeCount; ++s ) {
+        fprintf ( out, "%8d", sweep->sizes[s] );
+        for ( p = 0; p < sweep->policyCount; ++p ) {
+            fprintf ( out, " %9.4f", sweep->faults[s][p] / references );
+        }
+        fprintf ( out, " %9.4f\n", sweep->exactFaults[s] / references );
+    }
+}
@@ -0,0 +1,45 @@
+// File name: sweep.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the policy sweep (oss -R f -S sizes). Every combination of frame table
+//  size and replacement policy is simulated over the same mapped trace on a pool of threads,
+//  and exact LRU is worked out for every size at once from the trace's stack distances.
+
+#ifndef sweep_h
+#define sweep_h
+
+#include <stdio.h>
+
+#include "trace.h"
+#include "pager.h"
+
+
+/* Constants */
+#define MAX_SWEEP_SIZES 16
+#define MAX_SWEEP_POLICIES 8
+
+
+/* Structures */
+typedef struct {
+    int sizes[MAX_SWEEP_SIZES];             // Frame table sizes, in frames.
+    int sizeCount;
+    const char *policies[MAX_SWEEP_POLICIES];
+    int policyCount;
+    PagerConfig config;                     // Every simulation gets these settings, with its own size and policy.
+
+    // Results. faults[s][p] is the page faults for sizes[s] under policies[p], and
+    //  exactFaults[s] is exact LRU from the stack distances.
+    long references;
+    long faults[MAX_SWEEP_SIZES][MAX_SWEEP_POLICIES];
+    long exactFaults[MAX_SWEEP_SIZES];
+    double seconds;
+} Sweep;
+
+
+/* Function Prototypes */
+bool runSweep ( Sweep* sweep, const TraceMap* trace );
+void printSweep ( const Sweep* sweep, FILE* out );
+
+#endif
@@ -0,0 +1,163 @@
+// File name: tlb.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Simulated TLB for the pager. See tlb.h.
+
+#include "tlb.h"
+
+#include <stdlib.h>
+
+
+/* TLB helpers */
+// Function to get the first entry of the set a page (or a huge page, by its number) maps to.
+static TlbEntry* tlbSet ( Tlb* tlb, int blockIndex, int page ) {
+    return tlb->entries + ( (long) blockIndex * tlb->sets + page % tlb->sets ) * tlb->ways;
+}
+
+// Function to get the number of pages an entry in use covers.
+static int entryPages ( Tlb* tlb, TlbEntry* entry ) {
+    return entry->huge ? tlb->hugePages : 1;
+}
+
+// Function to fill a way of set with a translation. Takes an empty way if there is one, otherwise the least
+//  recently used one.
+static void fillEntry ( Tlb* tlb, TlbEntry* set, int blockIndex, int page, int frame, bool huge ) {
+    TlbEntry* victim = set;
+    int i;
+
+    for ( i = 0; i < tlb->ways; ++i ) {
+        if ( set[i].page == -1 ) {
+            victim = &set[i];
+            break;
+        }
+        if ( set[i].lastUse < victim->lastUse ) {
+            victim = &set[i];
+        }
+    }
+
+    if ( victim->page != -1 ) {
+        tlb->reach[blockIndex] -= entryPages ( tlb, victim );
+    }
+    victim->page = page;
+    victim->frame = frame;
+    victim->huge = huge;
+    victim->lastUse = ++tlb->tick;
+    tlb->reach[blockIndex] += entryPages ( tlb, victim );
+}
+
+
+/* Function Definitions */
+
+// Function to create a TLB of the given size for every PCB slot. entries should be a multiple of ways (oss
+//  rejects any other -L), and ways is clamped so there is at least one set (entries == ways is fully associative). hugePages is the pages a huge page covers (a power
+//  of two), 0 if there are none. Returns NULL if entries is 0 (no TLB).
+Tlb* createTlb ( int processes, int entries, int ways, int hugePages ) {
+    Tlb* tlb;
+    long i;
+
+    if ( entries <= 0 ) {
+        return NULL;
+    }
+    if ( ways <= 0 || ways > entries ) {
+        ways = entries;
+    }
+
+    tlb = (Tlb*) malloc ( sizeof ( Tlb ) );
+    tlb->processes = processes;
+    tlb->ways = ways;
+    tlb->sets = entries / ways;
+    tlb->tick = 0;
+    tlb->hugeHits = 0;
+    tlb->hugePages = hugePages;
+    for ( tlb->hugeOrder = 0; ( 1 << tlb->hugeOrder ) < hugePages; ++tlb->hugeOrder ) {
+    }
+    tlb->reach = (int*) calloc ( processes, sizeof ( int ) );
+    tlb->entries = (TlbEntry*) malloc ( (long) processes * tlb->sets * ways * sizeof ( TlbEntry ) );
+    for ( i = 0; i < (long) processes * tlb->sets * ways; ++i ) {
+        tlb->entries[i].page = -1;
+        tlb->entries[i].huge = false;
+    }
+
+    return tlb;
+}
+
+void destroyTlb ( Tlb* tlb ) {
+    free ( tlb->entries );
+    free ( tlb->reach );
+    free ( tlb );
+}
+
+// Function to look up the frame for a page, in its own entry or its huge page's. Returns -1 on a TLB miss.
+int tlbLookup ( Tlb* tlb, int blockIndex, int page ) {
+    TlbEntry* set = tlbSet ( tlb, blockIndex, page );
+    int i, first;
+
+    for ( i = 0; i < tlb->ways; ++i ) {
+        if ( set[i].page == page && !set[i].huge ) {
+            set[i].lastUse = ++tlb->tick;
+            return set[i].frame;
+        }
+    }
+
+    if ( tlb->hugePages == 0 ) {
+        return -1;
+    }
+    first = page & ~( tlb->hugePages - 1 );
+    set = tlbSet ( tlb, blockIndex, page >> tlb->hugeOrder );
+    for ( i = 0; i < tlb->ways; ++i ) {
+        if ( set[i].page == first && set[i].huge ) {
+            set[i].lastUse = ++tlb->tick;
+            tlb->hugeHits++;
+            return set[i].frame + ( page - first );
+        }
+    }
+    return -1;
+}
+
+// Function to add a translation after a page walk or page fault.
+void tlbInsert ( Tlb* tlb, int blockIndex, int page, int frame ) {
+    fillEntry ( tlb, tlbSet ( tlb, blockIndex, page ), blockIndex, page, frame, false );
+}
+
+// Function to add the translation for a huge page after a page walk: its first page and first frame.
+void tlbInsertHuge ( Tlb* tlb, int blockIndex, int page, int frame ) {
+    fillEntry ( tlb, tlbSet ( tlb, blockIndex, page >> tlb->hugeOrder ), blockIndex, page, frame, true );
+}
+
+// Function to drop the translation for a page that was just evicted (a TLB shootdown), and the one for the huge
+//  page it is part of if there is one.
+void tlbInvalidate ( Tlb* tlb, int blockIndex, int page ) {
+    TlbEntry* set = tlbSet ( tlb, blockIndex, page );
+    int i, first;
+
+    for ( i = 0; i < tlb->ways; ++i ) {
+        if ( set[i].page == page && !set[i].huge ) {
+            set[i].page = -1;
+            tlb->reach[blockIndex]--;
+        }
+    }
+
+    if ( tlb->hugePages == 0 ) {
+        return;
+    }
+    first = page & ~( tlb->hugePages - 1 );
+    set = tlbSet ( tlb, blockIndex, page >> tlb->hugeOrder );
+    for ( i = 0; i < tlb->ways; ++i ) {
+        if ( set[i].page == first && set[i].huge ) {
+            set[i].page = -1;
+            tlb->reach[blockIndex] -= tlb->hugePages;
+        }
+    }
+}
+
+// Function to drop every translation of a PCB slot when its process terminates.
+void tlbFlush ( Tlb* tlb, int blockIndex ) {
+    TlbEntry* entries = tlb->entries + (long) blockIndex * tlb->sets * tlb->ways;
+    int i;
+
+    for ( i = 0; i < tlb->sets * tlb->ways; ++i ) {
+        entries[i].page = -1;
+    }
+    tlb->reach[blockIndex] = 0;
+}
@@ -0,0 +1,50 @@
+// File name: tlb.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the simulated TLB. Each PCB slot gets its own set-associative TLB
+//  (entries / ways sets of ways entries, LRU within a set) that caches page to frame
+//  translations in front of the page table.
+//
+// With huge pages (oss -G) one entry can also cover a whole huge page. Both sizes share the
+//  entries: a page is looked for in the set of its own number, then in the set of its huge page's.
+//  The pages a process's entries cover between them is its TLB reach.
+
+#ifndef tlb_h
+#define tlb_h
+
+#include <stdbool.h>
+
+
+/* Structures */
+typedef struct {
+    int page;                   // -1 if the entry is empty. The first page of the huge page for a huge entry.
+    int frame;
+    bool huge;
+    unsigned long lastUse;
+} TlbEntry;
+
+typedef struct {
+    int processes;
+    int sets;
+    int ways;
+    int hugePages;              // Pages a huge entry covers, 0 if there are none.
+    int hugeOrder;              // log2 of hugePages.
+    TlbEntry *entries;          // processes x sets x ways.
+    int *reach;                 // Pages covered by each PCB slot's entries.
+    unsigned long tick;
+    unsigned long hugeHits;     // Lookups answered by a huge entry.
+} Tlb;
+
+
+/* Function Prototypes */
+Tlb* createTlb ( int processes, int entries, int ways, int hugePages );
+void destroyTlb ( Tlb* tlb );
+int tlbLookup ( Tlb* tlb, int blockIndex, int page );
+void tlbInsert ( Tlb* tlb, int blockIndex, int page, int frame );
+void tlbInsertHuge ( Tlb* tlb, int blockIndex, int page, int frame );
+void tlbInvalidate ( Tlb* tlb, int blockIndex, int page );
+void tlbFlush ( Tlb* tlb, int blockIndex );
+
+#endif
@@ -0,0 +1,250 @@
+// File name: trace.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Reading and writing memory reference traces. See trace.h for the file layout.
+
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+/* Function Definitions */
+
+// Function used by OSS to create (or truncate) a trace file and write its header.
+bool traceCreate ( const char* fileName, int processSlots, int pagesPerProcess ) {
+    TraceHeader header;
+    int fd;
+    bool written;
+
+    if ( ( fd = open ( fileName, O_WRONLY | O_CREAT | O_TRUNC, 0666 ) ) == -1 ) {
+        return false;
+    }
+
+    memset ( &header, 0, sizeof ( header ) );
+    memcpy ( header.magic, TRACE_MAGIC, sizeof ( header.magic ) );
+    header.version = TRACE_VERSION;
+    header.recordSize = sizeof ( TraceRecord );
+    header.processSlots = processSlots;
+    header.pagesPerProcess = pagesPerProcess;
+
+    written = write ( fd, &header, sizeof ( header ) ) == sizeof ( header );
+    close ( fd );
+
+    return written;
+}
+
+// Function used by USER to open a trace file created by OSS for appending.
+bool traceOpenWriter ( TraceWriter* writer, const char* fileName ) {
+    writer->count = 0;
+    writer->fd = open ( fileName, O_WRONLY | O_APPEND );
+
+    return writer->fd != -1;
+}
+
+// Function to add a record to the writer's buffer. The buffer is written out once it is full.
+//  The record is in the buffer before it is counted, so a flush from USER's SIGTERM handler never
+//  writes out half of one.
+void traceWrite ( TraceWriter* writer, const TraceRecord* record ) {
+    writer->buffer[writer->count] = *record;
+    __atomic_signal_fence ( __ATOMIC_SEQ_CST );
+    writer->count++;
+    if ( writer->count == TRACE_BUFFER ) {
+        traceFlush ( writer );
+    }
+}
+
+// Function to write out whatever is in the buffer. One write call per flush, so the records
+//  from one flush are never split up by another USER's. SIGTERM is held off until the buffer
+//  is emptied, so its handler can't write the same records a second time.
+void traceFlush ( TraceWriter* writer ) {
+    sigset_t stopSignal, oldMask;
+    
+    if ( writer->count > 0 ) {
+        sigemptyset ( &stopSignal );
+        sigaddset ( &stopSignal, SIGTERM );
+        sigprocmask ( SIG_BLOCK, &stopSignal, &oldMask );
+        if ( write ( writer->fd, writer->buffer, writer->count * sizeof ( TraceRecord ) ) == -1 ) {
+            perror ( "USER: Failure to write to trace file." );
+        }
+        writer->count = 0;
+        sigprocmask ( SIG_SETMASK, &oldMask, NULL );
+    }
+}
+
+void traceCloseWriter ( TraceWriter* writer ) {
+    traceFlush ( writer );
+    close ( writer->fd );
+}
+
+// Function to check a header read from a trace file.
+static bool validHeader ( const TraceHeader* header ) {
+    return memcmp ( header->magic, TRACE_MAGIC, sizeof ( header->magic ) ) == 0 &&
+           header->version == TRACE_VERSION && header->recordSize == sizeof ( TraceRecord );
+}
+
+// Run found while scanning a trace, before the runs are grouped by process.
+typedef struct {
+    int32_t pid;
+    int32_t blockIndex;
+    uint64_t firstRecord;
+    uint32_t length;
+} ScannedRun;
+
+// Used by qsort to group runs by process, keeping each process's runs in trace order.
+static int compareRuns ( const void* a, const void* b ) {
+    const ScannedRun* x = (const ScannedRun*) a;
+    const ScannedRun* y = (const ScannedRun*) b;
+
+    if ( x->pid != y->pid ) {
+        return x->pid < y->pid ? -1 : 1;
+    }
+    return x->firstRecord < y->firstRecord ? -1 : x->firstRecord > y->firstRecord;
+}
+
+// Function used by OSS, once every USER has stopped writing, to add the index to a trace file and fill
+//  in the header. A partial record at the end of the file (USER killed mid-write) is cut off first.
+bool traceFinalize ( const char* fileName ) {
+    TraceHeader header;
+    const TraceRecord* records;
+    ScannedRun* runs = NULL;
+    TraceProcess* processes;
+    TraceRun* index;
+    struct stat info;
+    uint64_t recordCount, i;
+    uint32_t runCount = 0, runCapacity = 0, processCount = 0, r;
+    bool written;
+    int fd;
+
+    if ( ( fd = open ( fileName, O_RDWR ) ) == -1 ) {
+        return false;
+    }
+
+    if ( pread ( fd, &header, sizeof ( header ), 0 ) != sizeof ( header ) || !validHeader ( &header ) ||
+         fstat ( fd, &info ) == -1 ) {
+        close ( fd );
+        return false;
+    }
+
+    recordCount = ( info.st_size - sizeof ( header ) ) / sizeof ( TraceRecord );
+    if ( ftruncate ( fd, sizeof ( header ) + recordCount * sizeof ( TraceRecord ) ) == -1 ) {
+        close ( fd );
+        return false;
+    }
+
+    // Find the runs of consecutive records from the same process.
+    if ( recordCount > 0 ) {
+        void* base = mmap ( NULL, sizeof ( header ) + recordCount * sizeof ( TraceRecord ), PROT_READ, MAP_SHARED, fd, 0 );
+        if ( base == MAP_FAILED ) {
+            close ( fd );
+            return false;
+        }
+        records = (const TraceRecord*) ( (const char*) base + sizeof ( header ) );
+
+        for ( i = 0; i < recordCount; ++i ) {
+            if ( runCount > 0 && runs[runCount - 1].pid == records[i].pid ) {
+                runs[runCount - 1].length++;
+                continue;
+            }
+            if ( runCount == runCapacity ) {
+                runCapacity = runCapacity ? runCapacity * 2 : 1024;
+                runs = (ScannedRun*) realloc ( runs, runCapacity * sizeof ( ScannedRun ) );
+            }
+            runs[runCount].pid = records[i].pid;
+            runs[runCount].blockIndex = records[i].blockIndex;
+            runs[runCount].firstRecord = i;
+            runs[runCount].length = 1;
+            runCount++;
+        }
+
+        munmap ( base, sizeof ( header ) + recordCount * sizeof ( TraceRecord ) );
+    }
+
+    // Group the runs by process and build the index.
+    qsort ( runs, runCount, sizeof ( ScannedRun ), compareRuns );
+    processes = (TraceProcess*) calloc ( runCount + 1, sizeof ( TraceProcess ) );
+    index = (TraceRun*) calloc ( runCount + 1, sizeof ( TraceRun ) );
+    for ( r = 0; r < runCount; ++r ) {
+        if ( r == 0 || runs[r].pid != runs[r - 1].pid ) {
+            processes[processCount].pid = runs[r].pid;
+            processes[processCount].blockIndex = runs[r].blockIndex;
+            processes[processCount].firstRun = r;
+            processCount++;
+        }
+        processes[processCount - 1].runCount++;
+        processes[processCount - 1].recordCount += runs[r].length;
+        index[r].firstRecord = runs[r].firstRecord;
+        index[r].length = runs[r].length;
+    }
+
+    header.recordCount = recordCount;
+    header.indexOffset = sizeof ( header ) + recordCount * sizeof ( TraceRecord );
+    header.processCount = processCount;
+    header.runCount = runCount;
+
+    written = pwrite ( fd, processes, processCount * sizeof ( TraceProcess ), header.indexOffset ) == (ssize_t) ( processCount * sizeof ( TraceProcess ) ) &&
+              pwrite ( fd, index, runCount * sizeof ( TraceRun ), header.indexOffset + processCount * sizeof ( TraceProcess ) ) == (ssize_t) ( runCount * sizeof ( TraceRun ) ) &&
+              pwrite ( fd, &header, sizeof ( header ), 0 ) == sizeof ( header );
+
+    free ( runs );
+    free ( processes );
+    free ( index );
+    close ( fd );
+
+    return written;
+}
+
+// Function to map a trace file for replay. Fails if the header doesn't match this version.
+bool traceMap ( TraceMap* trace, const char* fileName ) {
+    struct stat info;
+
+    memset ( trace, 0, sizeof ( TraceMap ) );
+    if ( ( trace->fd = open ( fileName, O_RDONLY ) ) == -1 ) {
+        return false;
+    }
+
+    if ( fstat ( trace->fd, &info ) == -1 || info.st_size < (off_t) sizeof ( TraceHeader ) ) {
+        close ( trace->fd );
+        return false;
+    }
+
+    trace->size = info.st_size;
+    if ( ( trace->base = mmap ( NULL, trace->size, PROT_READ, MAP_PRIVATE, trace->fd, 0 ) ) == MAP_FAILED ) {
+        close ( trace->fd );
+        return false;
+    }
+
+    trace->header = (const TraceHeader*) trace->base;
+    if ( !validHeader ( trace->header ) ) {
+        traceUnmap ( trace );
+        return false;
+    }
+
+    // Replay reads the records front to back.
+    madvise ( trace->base, trace->size, MADV_SEQUENTIAL );
+    trace->records = (const TraceRecord*) ( (const char*) trace->base + sizeof ( TraceHeader ) );
+
+    if ( trace->header->indexOffset != 0 ) {
+        trace->recordCount = trace->header->recordCount;
+        trace->processes = (const TraceProcess*) ( (const char*) trace->base + trace->header->indexOffset );
+        trace->processCount = trace->header->processCount;
+        trace->runs = (const TraceRun*) ( trace->processes + trace->processCount );
+        trace->runCount = trace->header->runCount;
+    } else {
+        trace->recordCount = ( trace->size - sizeof ( TraceHeader ) ) / sizeof ( TraceRecord );
+    }
+
+    return true;
+}
+
+void traceUnmap ( TraceMap* trace ) {
+    munmap ( trace->base, trace->size );
+    close ( trace->fd );
+}
@@ -0,0 +1,110 @@
+// File name: trace.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for memory reference traces. USER records its references to a trace file
+//  when oss is run with -t, and oss -R replays a trace straight into the frame table
+//  without creating any processes.
+//
+// File layout: a 64 byte header, the records in the order USER wrote them, then an index.
+//  The index is written by OSS once every USER has stopped (traceFinalize). It lists, for each
+//  process, the runs of consecutive records that belong to it, so a process's references can be
+//  found without scanning the whole trace. A trace that was never finalized has no index and its
+//  record count is worked out from the file size.
+
+#ifndef trace_h
+#define trace_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* Constants */
+#define TRACE_MAGIC "OSSTRACE"
+#define TRACE_VERSION 2
+#define TRACE_BUFFER 64         // Records USER buffers before writing them out.
+
+// Flags stored with each record.
+#define TRACE_WRITE 0x01        // Reference was a write (otherwise a read).
+#define TRACE_TERMINATE 0x02    // Process terminated. Only pid, blockIndex and time are set.
+
+
+/* Structures */
+// Header at the start of every trace file. 64 bytes so the records start on a cache line.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t recordCount;       // 0 until the trace is finalized.
+    uint64_t indexOffset;       // Offset of the process table, 0 until the trace is finalized.
+    uint32_t processCount;
+    uint32_t runCount;
+    uint32_t processSlots;      // PCB slots and pages per process of the run that recorded the trace.
+    uint32_t pagesPerProcess;
+    uint8_t reserved[16];
+} TraceHeader;
+
+// One memory reference (or termination). 24 bytes, no padding.
+typedef struct {
+    int32_t pid;
+    int16_t blockIndex;
+    uint8_t flags;
+    uint8_t reserved;
+    int32_t pageRef;
+    int32_t memoryAddress;
+    uint32_t sentTime[2];
+} TraceRecord;
+
+// Buffered writer used by USER. Buffers are written with O_APPEND so several USERs can
+//  share one trace file without overwriting each other.
+typedef struct {
+    int fd;
+    int count;
+    TraceRecord buffer[TRACE_BUFFER];
+} TraceWriter;
+
+// Index entry for one process. Its runs are runs[firstRun] to runs[firstRun + runCount - 1].
+typedef struct {
+    int32_t pid;
+    int32_t blockIndex;
+    uint32_t firstRun;
+    uint32_t runCount;
+    uint64_t recordCount;
+} TraceProcess;
+
+// Consecutive records from the same process.
+typedef struct {
+    uint64_t firstRecord;
+    uint32_t length;
+    uint32_t reserved;
+} TraceRun;
+
+// A trace mapped into memory for replay. processes and runs are NULL if the trace has no index.
+typedef struct {
+    int fd;
+    size_t size;
+    void *base;
+    const TraceHeader *header;
+    const TraceRecord *records;
+    uint64_t recordCount;
+    const TraceProcess *processes;
+    uint32_t processCount;
+    const TraceRun *runs;
+    uint32_t runCount;
+} TraceMap;
+
+
+/* Function Prototypes */
+bool traceCreate ( const char* fileName, int processSlots, int pagesPerProcess );
+bool traceOpenWriter ( TraceWriter* writer, const char* fileName );
+void traceWrite ( TraceWriter* writer, const TraceRecord* record );
+void traceFlush ( TraceWriter* writer );
+void traceCloseWriter ( TraceWriter* writer );
+
+bool traceFinalize ( const char* fileName );
+bool traceMap ( TraceMap* trace, const char* fileName );
+void traceUnmap ( TraceMap* trace );
+
+#endif
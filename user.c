@@ -7,6 +7,26 @@
 //  Operating System Simulator ). See oss.c for more info.
 
 #include "header.h"
+#include "pager.h"
+#include "trace.h"
+#include "workload.h"
+
+void generateReference ( Reference* ref );
+bool sendRequest ( void* buffer, size_t size, int index );
+bool receiveResponse ( void* buffer, size_t size, int index, long myPID );
+bool receiveStart ( void* buffer, size_t size, int index, long realPID );
+void recordReference ( const Reference* ref, bool terminate );
+
+// Trace recording (oss -t). Only used if OSS passed a trace file name.
+TraceWriter traceWriter;
+bool tracing = false;
+
+// Address space geometry, passed in by OSS.
+int pageSize = DEFAULT_PAGE_SIZE;
+int pagesPerProcess = DEFAULT_PAGES_PER_PROCESS;
+
+// Workload the references are generated from (oss -W). Its random number generator is used for everything.
+Workload workload;
 
 
 int main ( int argc, char *argv[] ) {
@@ -15,20 +35,48 @@ int main ( int argc, char *argv[] ) {
     long myPID = getpid();          // Store the USER PID.
     long ossPID = getppid();        // Store the OSS's PID.
     int index = atoi( argv[1] );    // Store the argument that was passed from OSS through execl.
+    if ( argc > 2 ) {
+        transport = atoi( argv[2] );    // Transport selected by OSS. Defaults to the message queue.
+    }
+    int batchSize = 1;              // Number of references per request. Set by OSS with -b.
+    if ( argc > 3 ) {
+        batchSize = atoi( argv[3] );
+    }
+    if ( argc > 4 && argv[4][0] != '\0' ) {
+        tracing = true;     // Name of the trace file to record references to.
+    }
+    if ( argc > 6 ) {
+        pageSize = atoi( argv[5] );
+        pagesPerProcess = atoi( argv[6] );
+    }
+    long requestType = ossPID;      // Message type requests are sent as. With OSS worker threads, the shard's.
+    if ( argc > 7 && atoi( argv[7] ) > 1 ) {
+        requestType = index % atoi( argv[7] ) + 1;
+    }
+    bool pooled = ( argc > 8 && atoi( argv[8] ) == 1 );    // Part of OSS's pre-forked pool (oss -F).
+    bool running = true;            // Cleared if OSS shuts the ring transport down.
+    if ( !createWorkload( &workload, ( argc > 9 ) ? argv[9] : DEFAULT_WORKLOAD, pagesPerProcess ) ) {
+        fprintf( stderr, "USER: Unknown workload %s.\n", argv[9] );
+        return 1;
+    }
+    long processNumber = ( argc > 10 ) ? atol( argv[10] ) : 0;    // Seeds the workload. Set by OSS.
     
 //    printf( "Process %ld created by Parent %ld is being following at index %d in the PCB.\n", myPID, ossPID, index );
     
-    // Set a seed unique to each individual process for random number generation.
-    time_t seed;
-    srand( (int)time( &seed ) % getppid() );
-    
     // General Variables
+    int i;
     int numberOfRequests = 0;   // Counter for the number of memory requests made by USER.
-    int address;                // Store the random address creating during the main loop.
-    int pageNeeded;             // Store the page associated with that random address.
-    int memoryRequestType;      // Store the bit flag that represent the random type of request by USER.
-    int memoryRequestRNG;       
+    Reference reference;        // Store the random address, page and request type created during the main loop.
     int terminationRNG;
+    uint64_t now;               // Simulated time the request is sent at.
+    
+    // In batch mode the whole batch is sent and answered as a single request.
+    void *buffer = &message;
+    size_t size = sizeof( message );
+    if ( batchSize > 1 ) {
+        buffer = &batch;
+        size = batchMessageSize( batchSize );
+    }
     
     /* Signal Handling */
     if ( signal ( SIGINT, sig_handle) == -1 ) {
@@ -36,15 +84,21 @@ int main ( int argc, char *argv[] ) {
         return 1;
     }
     
+    // OSS stops any USER still running with SIGTERM once a traced run is over.
+    if ( signal ( SIGTERM, sig_handle) == SIG_ERR ) {
+        perror ( "USER: Failure to setup signal handing." );
+        return 1;
+    }
+    
     /* Shared Memory */
     // Connect to shared memory.
-    if ( ( shmClockID = shmget(shmKey, ( 2 * sizeof ( unsigned int ) ), 0666 ) ) == -1 ) {
+    if ( ( shmClockID = shmget(shmKey, sizeof ( SimClock ), 0666 ) ) == -1 ) {
         perror ( "USER: Failure to find shared memory space for simulated clock." );
         return 1;
     }
     
     // Attach to shared memory.
-    if ( ( shmClock = ( int *) shmat(shmClockID, NULL, 0) ) < 0 ) {
+    if ( ( shmClock = ( SimClock *) shmat(shmClockID, NULL, 0) ) == (void *) -1 ) {
         perror ( "USER: Failure to attach to shared memory space for simulated clock." );
     }
     
@@ -55,79 +109,207 @@ int main ( int argc, char *argv[] ) {
         return 1;
     }
     
+    // Connect and attach to the ring transport if OSS selected it.
+    if ( transport == TRANSPORT_RING ) {
+        if ( ( shmRingID = shmget( shmRingKey, 0, 0666 ) ) == -1 ) {
+            perror ( "USER: Failure to find shared memory space for ring transport." );
+            return 1;
+        }
+        
+        if ( ( shmRing = (RingSet *) shmat( shmRingID, NULL, 0 ) ) == (void *) -1 ) {
+            perror ( "USER: Failure to attach to shared memory space for ring transport." );
+            return 1;
+        }
+    }
+    
+    // Open the trace file OSS created.
+    if ( tracing && !traceOpenWriter( &traceWriter, argv[4] ) ) {
+        perror ( "USER: Failure to open the trace file." );
+        return 1;
+    }
+    
     /* Main Loop */
-    while ( 1 ) {
-        // Prepare the message content each run.
-        message.pid = myPID;
-        message.msg_type = ossPID;
-        message.blockIndex = index;
-        message.terminate = 0;
-        message.sentTime[0] = shmClock[0];
-        message.sentTime[1] = shmClock[1];
+    // A pooled USER runs one simulated process after another in its PCB slot. OSS starts each one with a message
+    //  carrying the process's logical PID, and once it terminates the USER waits for the next.
+    do {
+        if ( pooled ) {
+            if ( !receiveStart( buffer, size, index, getpid() ) ) {
+                break;
+            }
+            myPID = ( batchSize > 1 ) ? batch.pid : message.pid;
+            processNumber = myPID;
+            numberOfRequests = 0;
+        }
         
-        // Generate random numbers to determine the action for current run through loop.
-        memoryRequestRNG = ( rand() % ( 100 - 0 + 1 ) + 0 );
-        terminationRNG = ( rand() % ( 100 - 0 + 1 ) + 0 );
+        // The workload starts over for every process, seeded from the PCB index and the process number.
+        startWorkload( &workload, index, processNumber );
         
-        /* 1 - Check if process is going to terminate. */
-        // Process can potentially terminate if it has made at least 1000 memory requests. After
-        //  reaching that threshold, if terminationRNG was between 80-100, USER will terminate.
-        //  These numbers can be adjusted to tune exit rates of child processes.
-        if ( ( numberOfRequests >= 1000 ) && ( terminationRNG >= 80 ) ) {
-            message.terminate = 1;
+        while ( 1 ) {
+            // Prepare the message content each run.
+            message.pid = myPID;
+            message.msg_type = requestType;
+            message.blockIndex = index;
+            message.terminate = 0;
+            now = clockNow( shmClock );
+            message.sentTime[0] = clockSeconds( now );
+            message.sentTime[1] = clockNanoseconds( now );
+            
+            batch.pid = myPID;
+            batch.msg_type = requestType;
+            batch.blockIndex = index;
+            batch.terminate = 0;
+            batch.count = 0;
+            batch.sentTime[0] = message.sentTime[0];
+            batch.sentTime[1] = message.sentTime[1];
             
-            if ( msgsnd( messageID, &message, sizeof( message ), 1 ) == -1 ) {
-                perror ( "USER: Failure to send termination message to OSS." );
+            // Generate random numbers to determine the action for current run through loop.
+            terminationRNG = prngBelow( &workload.rng, 101 );
+            
+            /* 1 - Check if process is going to terminate. */
+            // Process can potentially terminate if it has made at least 1000 memory requests. After
+            //  reaching that threshold, if terminationRNG was between 80-100, USER will terminate.
+            //  These numbers can be adjusted to tune exit rates of child processes.
+            if ( ( numberOfRequests >= 1000 ) && ( terminationRNG >= 80 ) ) {
+                message.terminate = 1;
+                batch.terminate = 1;
+                recordReference( NULL, true );
+            
+                if ( !sendRequest( buffer, size, index ) ) {
+                    perror ( "USER: Failure to send termination message to OSS." );
+                    return 1;
+                }
+            
+                break;  // Break out of loop and terminate.
+            }
+            
+            /* 2/3 - Determine the page, address and type of the memory request(s). In batch mode the whole
+             batch is generated up front. */
+            if ( batchSize > 1 ) {
+                for ( i = 0; i < batchSize; ++i ) {
+                    generateReference( &batch.refs[i] );
+                    recordReference( &batch.refs[i], false );
+                }
+                batch.count = batchSize;
+            } else {
+                generateReference( &reference );
+                recordReference( &reference, false );
+            }
+            
+            /* 4 - Send memory request message to OSS. */
+            // Prepare the rest of the message content.
+            message.memoryAddress = reference.memoryAddress;
+            message.pageRef = reference.pageRef;
+            message.requestType = reference.requestType;
+            
+//            printf( "REQUEST - TO: %ld FROM: %ld PCB: %d TYPE: %d ADDRESS: %d PAGE: %d", message.msg_type, message.pid, message.blockIndex, message.requestType, message.memoryAddress, message.pageRef );
+            
+            // Send message to OSS.
+            if ( !sendRequest( buffer, size, index ) ) {
+                perror( "USER: Failure to send request to OSS." );
                 return 1;
             }
             
-            break;  // Break out of loop and terminate.
-        }
-        
-        /* 2 - Determine the page that USER will reference in its memory request. */
-        // Generate an number between 0-31000. This will be the fake memory address USER wants to access.
-        address = ( rand() % ( 31000 - 0 + 1 ) + 0 );
-        
-        // Divide address by 1000 to give the fake page that address is stored in with respect to the USER's entry
-        //  in the Process Control Block in OSS.
-        pageNeeded = ( rand() % ( 31 - 0 + 1 ) + 0 );
-        
-        /* 3 - Determine if the memory request will be read of write...50/50 chance. */
-        // If memoryRequestRNG was less than 50, the request will be write (0). Otherwise, the request will be write (1).
-        if ( memoryRequestRNG < 50 ) {
-            memoryRequestType = 0;
-        } else {
-            memoryRequestType = 1;
-        }
-        
-        /* 4 - Send memory request message to OSS. */
-        // Prepare the rest of the message content.
-        message.memoryAddress = address;
-        message.pageRef = pageNeeded;
-        message.requestType = memoryRequestType;
-        
-//        printf( "REQUEST - TO: %ld FROM: %ld PCB: %d TYPE: %d ADDRESS: %d PAGE: %d", message.msg_type, message.pid, message.blockIndex, message.requestType, message.memoryAddress, message.pageRef );
-        
-        // Send message to OSS.
-        if ( msgsnd( messageID, &message, sizeof ( message ), 1 ) == -1 ) {
-            perror( "USER: Failure to send request to OSS." );
-            return 1;
+            /* 5 - Wait for response from OSS. */
+            // If OSS shut the ring transport down instead of answering, there is nothing left to do.
+            if ( !receiveResponse( buffer, size, index, myPID ) ) {
+                running = false;
+                break;
+            }
+//            printf( "Process %ld received response from OSS and is continuing.\n" );
+            
+            /* 6 - Increase the counter tracking the number of memory requests made by USER. */
+            numberOfRequests += ( batchSize > 1 ) ? batch.count : 1;
         }
-        
-        /* 5 - Wait for response from OSS. */
-        msgrcv( messageID, &message, sizeof( message ), myPID, 0 );
-//        printf( "Process %ld received response from OSS and is continuing.\n" );
-        
-        /* 6 - Increase the counter tracking the number of memory requests made by USER. */
-        numberOfRequests++;
-    }
+    } while ( pooled && running );
     
 //    printf( "Process %ld is terminating after having made %d memory requests.\n", myPID, numberOfRequests );
     
+    if ( tracing ) {
+        traceCloseWriter( &traceWriter );
+    }
+    
     return 0;
 } // End of main
 
 
+// Function to generate one random memory reference.
+void generateReference ( Reference* ref ) {
+    int memoryRequestRNG = prngBelow( &workload.rng, 101 );
+    
+    /* 2 - Determine the page that USER will reference in its memory request. */
+    // The workload picks the page with respect to the USER's entry in the Process Control Block in OSS. The fake
+    //  memory address USER wants to access is somewhere inside that page.
+    ref->pageRef = workloadNextPage( &workload );
+    ref->memoryAddress = ref->pageRef * pageSize + (int) prngBelow( &workload.rng, pageSize );
+    
+    /* 3 - Determine if the memory request will be read of write...50/50 chance. */
+    // If memoryRequestRNG was less than 50, the request will be write (0). Otherwise, the request will be write (1).
+    if ( memoryRequestRNG < 50 ) {
+        ref->requestType = 0;
+    } else {
+        ref->requestType = 1;
+    }
+    ref->result = REFERENCE_HIT;
+}
+
+// Function to add a reference (or the termination, if ref is NULL) to the trace if one is being recorded.
+//  The PID, PCB index and send time come from the message being prepared.
+void recordReference ( const Reference* ref, bool terminate ) {
+    TraceRecord record;
+    
+    if ( !tracing ) {
+        return;
+    }
+    
+    memset( &record, 0, sizeof( record ) );
+    record.pid = message.pid;
+    record.blockIndex = message.blockIndex;
+    record.sentTime[0] = message.sentTime[0];
+    record.sentTime[1] = message.sentTime[1];
+    
+    if ( terminate ) {
+        record.flags = TRACE_TERMINATE;
+    } else {
+        record.flags = ( ref->requestType == 1 ) ? TRACE_WRITE : 0;
+        record.pageRef = ref->pageRef;
+        record.memoryAddress = ref->memoryAddress;
+    }
+    
+    traceWrite( &traceWriter, &record );
+}
+
+// Function to send a request (single message or batch) to OSS over the selected transport.
+bool sendRequest ( void* buffer, size_t size, int index ) {
+    if ( transport == TRANSPORT_RING ) {
+        ringSendRequest( shmRing, index, buffer, size );
+        return true;
+    }
+    
+    return msgsnd( messageID, buffer, size - sizeof( long ), 1 ) != -1;
+}
+
+// Function used by a pooled USER to wait for OSS to start its next process. The start message comes to the
+//  USER's real PID (or its response ring). Returns false if OSS shut down instead.
+bool receiveStart ( void* buffer, size_t size, int index, long realPID ) {
+    if ( transport == TRANSPORT_RING ) {
+        return ringReceiveResponse( shmRing, index, buffer, size );
+    }
+    
+    return msgrcv( messageID, buffer, size - sizeof( long ), realPID, 0 ) != -1;
+}
+
+// Function to wait for OSS's response over the selected transport. Returns false if the ring
+//  transport was shut down by OSS.
+bool receiveResponse ( void* buffer, size_t size, int index, long myPID ) {
+    if ( transport == TRANSPORT_RING ) {
+        return ringReceiveResponse( shmRing, index, buffer, size );
+    }
+    
+    msgrcv( messageID, buffer, size - sizeof( long ), myPID, 0 );
+    return true;
+}
+
+
 void sig_handle ( sig_num ) {
     
     if ( sig_num == SIGINT ) {
@@ -136,4 +318,13 @@ void sig_handle ( sig_num ) {
         exit ( 0 );
     }
     
+    // Write out the references still in the trace buffer before stopping, so none are lost from the trace.
+    if ( sig_num == SIGTERM ) {
+        if ( tracing ) {
+            traceFlush( &traceWriter );
+        }
+        
+        _exit ( 0 );
+    }
+    
 } // End of sig_handle
@@ -0,0 +1,235 @@
+// File name: workload.c
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// USER workload generators and their random number generator. See workload.h.
+
+#include "workload.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+/* Random numbers */
+
+static uint64_t rotateLeft ( uint64_t x, int k ) {
+    return ( x << k ) | ( x >> ( 64 - k ) );
+}
+
+// Function to step a splitmix64 generator. Only used to spread a seed over the xoshiro state.
+static uint64_t splitMix ( uint64_t* x ) {
+    uint64_t z = ( *x += 0x9e3779b97f4a7c15ULL );
+
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+    return z ^ ( z >> 31 );
+}
+
+void prngSeed ( Prng* rng, uint64_t seed ) {
+    int i;
+
+    for ( i = 0; i < 4; ++i ) {
+        rng->s[i] = splitMix ( &seed );
+    }
+}
+
+// Function to get the next 64 random bits (xoshiro256**).
+uint64_t prngNext ( Prng* rng ) {
+    uint64_t* s = rng->s;
+    uint64_t result = rotateLeft ( s[1] * 5, 7 ) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotateLeft ( s[3], 45 );
+
+    return result;
+}
+
+// Function to get a random number from 0 to bound - 1. Uses a multiply instead of %, so there is no
+//  division; the bias is at most bound / 2^32.
+uint32_t prngBelow ( Prng* rng, uint32_t bound ) {
+    return (uint32_t) ( ( ( prngNext ( rng ) >> 32 ) * bound ) >> 32 );
+}
+
+// Function to get a random number in [0, 1).
+double prngUniform ( Prng* rng ) {
+    return ( prngNext ( rng ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+}
+
+
+/* Generators */
+
+// Function to pick a page from the Zipf distribution by binary search on its cumulative probabilities.
+static int zipfPage ( Workload* workload ) {
+    double u = prngUniform ( &workload->rng );
+    int low = 0, high = workload->pages - 1, middle;
+
+    while ( low < high ) {
+        middle = ( low + high ) / 2;
+        if ( workload->zipfCdf[middle] < u ) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// Function to pick a page from the working set, sliding or moving the window first if it is time to. Over a
+//  phase the window slides forward by its own size, one page at a time.
+static int workingSetPage ( Workload* workload ) {
+    long slide = workload->phaseLength / workload->windowPages;
+
+    if ( slide < 1 ) {
+        slide = 1;
+    }
+
+    if ( workload->generated > 0 && workload->generated % workload->phaseLength == 0 ) {
+        workload->windowBase = prngBelow ( &workload->rng, workload->pages );
+    } else if ( workload->generated > 0 && workload->generated % slide == 0 ) {
+        workload->windowBase = ( workload->windowBase + 1 ) % workload->pages;
+    }
+
+    return ( workload->windowBase + prngBelow ( &workload->rng, workload->windowPages ) ) % workload->pages;
+}
+
+static int nextPageOf ( Workload* workload, int kind ) {
+    int page;
+
+    switch ( kind ) {
+        case WORKLOAD_ZIPF:
+            return zipfPage ( workload );
+        case WORKLOAD_WORKING_SET:
+            return workingSetPage ( workload );
+        case WORKLOAD_SEQUENTIAL:
+            page = workload->nextPage;
+            workload->nextPage = ( page + 1 ) % workload->pages;
+            return page;
+        default:
+            return prngBelow ( &workload->rng, workload->pages );
+    }
+}
+
+
+/* Function Definitions */
+
+// Function to set up a workload from its spec (see workload.h) for a process with the given number of pages.
+//  Returns false if the spec isn't one of the workloads or its numbers are out of range.
+bool createWorkload ( Workload* workload, const char* spec, int pages ) {
+    const char* arguments = strchr ( spec, ':' );
+    size_t nameLength = arguments != NULL ? (size_t) ( arguments - spec ) : strlen ( spec );
+    double sum = 0.0;
+    int i;
+
+    memset ( workload, 0, sizeof ( Workload ) );
+    workload->pages = pages;
+    workload->skew = 1.0;
+    workload->windowPages = 8;
+    workload->phaseLength = 2000;
+    workload->weights[WORKLOAD_UNIFORM] = 10;
+    workload->weights[WORKLOAD_ZIPF] = 30;
+    workload->weights[WORKLOAD_WORKING_SET] = 50;
+    workload->weights[WORKLOAD_SEQUENTIAL] = 10;
+    if ( arguments != NULL ) {
+        arguments++;
+    }
+
+    if ( nameLength == 7 && strncmp ( spec, "uniform", 7 ) == 0 ) {
+        workload->kind = WORKLOAD_UNIFORM;
+    } else if ( nameLength == 4 && strncmp ( spec, "zipf", 4 ) == 0 ) {
+        workload->kind = WORKLOAD_ZIPF;
+        if ( arguments != NULL && ( workload->skew = atof ( arguments ) ) < 0.0 ) {
+            return false;
+        }
+    } else if ( nameLength == 2 && strncmp ( spec, "ws", 2 ) == 0 ) {
+        workload->kind = WORKLOAD_WORKING_SET;
+        if ( arguments != NULL && ( sscanf ( arguments, "%d,%d", &workload->windowPages, &workload->phaseLength ) < 1 || workload->windowPages < 1 || workload->phaseLength < 1 ) ) {
+            return false;
+        }
+    } else if ( nameLength == 3 && strncmp ( spec, "seq", 3 ) == 0 ) {
+        workload->kind = WORKLOAD_SEQUENTIAL;
+    } else if ( nameLength == 3 && strncmp ( spec, "mix", 3 ) == 0 ) {
+        workload->kind = WORKLOAD_MIX;
+        if ( arguments != NULL && sscanf ( arguments, "%d,%d,%d,%d", &workload->weights[0], &workload->weights[1], &workload->weights[2], &workload->weights[3] ) != WORKLOAD_MIX ) {
+            return false;
+        }
+        for ( i = 0; i < WORKLOAD_MIX; ++i ) {
+            if ( workload->weights[i] < 0 ) {
+                return false;
+            }
+            sum += workload->weights[i];
+        }
+        if ( sum == 0.0 ) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    if ( workload->windowPages > pages ) {
+        workload->windowPages = pages;
+    }
+
+    // Zipf needs the cumulative probability of every page.
+    if ( workload->kind == WORKLOAD_ZIPF || ( workload->kind == WORKLOAD_MIX && workload->weights[WORKLOAD_ZIPF] > 0 ) ) {
+        workload->zipfCdf = (double*) malloc ( pages * sizeof ( double ) );
+        sum = 0.0;
+        for ( i = 0; i < pages; ++i ) {
+            sum += 1.0 / pow ( i + 1, workload->skew );
+            workload->zipfCdf[i] = sum;
+        }
+        for ( i = 0; i < pages; ++i ) {
+            workload->zipfCdf[i] /= sum;
+        }
+    }
+
+    return true;
+}
+
+void destroyWorkload ( Workload* workload ) {
+    free ( workload->zipfCdf );
+    workload->zipfCdf = NULL;
+}
+
+// Function to start the workload over for a new process. The random numbers depend only on the PCB index and
+//  the process number, so the same run always makes the same references.
+void startWorkload ( Workload* workload, int blockIndex, long processNumber ) {
+    prngSeed ( &workload->rng, ( (uint64_t) blockIndex << 40 ) ^ (uint64_t) processNumber );
+    workload->generated = 0;
+    workload->windowBase = prngBelow ( &workload->rng, workload->pages );
+    workload->nextPage = 0;
+}
+
+// Function to get the page the next memory reference goes to.
+int workloadNextPage ( Workload* workload ) {
+    int kind = workload->kind;
+    int pick, total = 0, i;
+    int page;
+
+    if ( kind == WORKLOAD_MIX ) {
+        for ( i = 0; i < WORKLOAD_MIX; ++i ) {
+            total += workload->weights[i];
+        }
+        pick = prngBelow ( &workload->rng, total );
+        for ( kind = 0; pick >= workload->weights[kind]; ++kind ) {
+            pick -= workload->weights[kind];
+        }
+    }
+
+    page = nextPageOf ( workload, kind );
+    workload->generated++;
+
+    return page;
+}
+
+// Function to list the workloads for help and error messages.
+const char* workloadNames() {
+    return "uniform, zipf[:s], ws[:size,phase], seq, mix[:u,z,w,s]";
+}
@@ -0,0 +1,75 @@
+// File name: workload.h
+// Header file
+// Created by: Andrew Audrain
+// Created on: 10/17/2026
+//
+// Header file for the USER workload generators. A workload decides which page each memory
+//  reference goes to. OSS picks one with -W and passes the spec to every USER:
+//
+//  uniform             Every page equally likely (the original behaviour).
+//  zipf[:s]            Page p (0 is hottest) with probability proportional to 1 / (p + 1)^s. Default s 1.0.
+//  ws[:size,phase]     A working set of size pages. Over each phase of that many references the window
+//                      slides forward by its own size, a page at a time, then jumps somewhere new.
+//                      Default 8,2000.
+//  seq                 Scan the address space one page after another, wrapping around.
+//  mix[:u,z,w,s]       Each reference picks one of the above (with its defaults) by percent weight.
+//                      Default 10,30,50,10.
+//
+// Random numbers come from a xoshiro256** generator per process, seeded from its PCB index and
+//  process number, so a run's references don't depend on when USER was started.
+
+#ifndef workload_h
+#define workload_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/* Constants */
+#define DEFAULT_WORKLOAD "uniform"
+
+enum { WORKLOAD_UNIFORM = 0, WORKLOAD_ZIPF, WORKLOAD_WORKING_SET, WORKLOAD_SEQUENTIAL, WORKLOAD_MIX, WORKLOAD_KINDS };
+
+
+/* Structures */
+// xoshiro256** state.
+typedef struct {
+    uint64_t s[4];
+} Prng;
+
+typedef struct {
+    int kind;
+    int pages;
+    Prng rng;
+
+    // Zipf: cumulative probability of each page.
+    double skew;
+    double *zipfCdf;
+
+    // Working set: window of windowPages pages starting at windowBase.
+    int windowPages;
+    int phaseLength;
+    int windowBase;
+    long generated;             // References generated since the process started.
+
+    // Sequential scan: next page.
+    int nextPage;
+
+    // Mix: percent weight of each kind, WORKLOAD_UNIFORM to WORKLOAD_SEQUENTIAL.
+    int weights[WORKLOAD_MIX];
+} Workload;
+
+
+/* Function Prototypes */
+void prngSeed ( Prng* rng, uint64_t seed );
+uint64_t prngNext ( Prng* rng );
+uint32_t prngBelow ( Prng* rng, uint32_t bound );
+double prngUniform ( Prng* rng );
+
+bool createWorkload ( Workload* workload, const char* spec, int pages );
+void destroyWorkload ( Workload* workload );
+void startWorkload ( Workload* workload, int blockIndex, long processNumber );
+int workloadNextPage ( Workload* workload );
+const char* workloadNames ( void );
+
+#endif